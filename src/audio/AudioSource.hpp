@@ -10,6 +10,8 @@ class AudioSource {
     virtual ~AudioSource() {}
     virtual void read(std::vector<float> &samples) = 0;
     virtual unsigned int getSampleRate() = 0;
+    /* Cancel a read blocked in another thread, for sources that may stall */
+    virtual void cancel() {}
 };
 
 class OpenException : public std::runtime_error {
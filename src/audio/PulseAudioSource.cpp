@@ -5,7 +5,7 @@
 
 namespace Audio {
 
-PulseAudioSource::PulseAudioSource(unsigned int sampleRate) : _sampleRate(sampleRate) {
+PulseAudioSource::PulseAudioSource(unsigned int sampleRate, std::string device) : _sampleRate(sampleRate) {
     pa_sample_spec ss;
     ss.format = PA_SAMPLE_FLOAT32LE;
     ss.rate = sampleRate;
@@ -19,9 +19,9 @@ PulseAudioSource::PulseAudioSource(unsigned int sampleRate) : _sampleRate(sample
     attr.fragsize = 1024;
 
     int error;
-    _handle = pa_simple_new(nullptr, "audioprism", PA_STREAM_RECORD, nullptr, "audio in", &ss, nullptr, &attr, &error);
+    _handle = pa_simple_new(nullptr, "audioprism", PA_STREAM_RECORD, (device == "") ? nullptr : device.c_str(), "audio in", &ss, nullptr, &attr, &error);
     if (_handle == nullptr)
-        throw OpenException("Opening PulseAudio: pa_simple_new(): " + std::string(pa_strerror(error)));
+        throw OpenException("Opening PulseAudio" + ((device == "") ? std::string("") : " source " + device) + ": pa_simple_new(): " + std::string(pa_strerror(error)));
 }
 
 PulseAudioSource::~PulseAudioSource() {
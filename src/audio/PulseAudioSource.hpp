@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <pulse/simple.h>
 
 #include "AudioSource.hpp"
@@ -8,7 +10,8 @@ namespace Audio {
 
 class PulseAudioSource : public AudioSource {
   public:
-    PulseAudioSource(unsigned int sampleRate);
+    /* Open default source, or named source device */
+    PulseAudioSource(unsigned int sampleRate, std::string device = "");
     ~PulseAudioSource();
     virtual void read(std::vector<float> &samples);
     virtual unsigned int getSampleRate();
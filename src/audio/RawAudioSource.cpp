@@ -0,0 +1,130 @@
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "RawAudioSource.hpp"
+
+namespace Audio {
+
+std::string to_string(const RawAudioSource::Format &format) {
+    if (format == RawAudioSource::Format::S16)
+        return "s16";
+    else if (format == RawAudioSource::Format::F32)
+        return "f32";
+
+    return "";
+}
+
+constexpr size_t RawAudioSource::BufferSize;
+
+RawAudioSource::RawAudioSource(std::string path, Format format, unsigned int sampleRate, unsigned int channels) : _stdin(path == "-"), _format(format), _sampleRate(sampleRate), _channels(channels), _buffer(BufferSize), _cancelled(false) {
+    /* Open blocking, so a FIFO open waits for its writer */
+    if (_stdin) {
+        _fd = STDIN_FILENO;
+    } else if ((_fd = open(path.c_str(), O_RDONLY)) < 0) {
+        throw OpenException("Error opening raw audio " + path + ": " + std::string(strerror(errno)));
+    }
+
+    /* Then read without blocking, waiting for data with poll() */
+    _flags = fcntl(_fd, F_GETFL);
+    if (_flags < 0 || fcntl(_fd, F_SETFL, _flags | O_NONBLOCK) < 0) {
+        int error = errno;
+        if (!_stdin)
+            close(_fd);
+        throw OpenException("Error configuring raw audio " + path + ": " + std::string(strerror(error)));
+    }
+}
+
+RawAudioSource::~RawAudioSource() {
+    /* Restore standard input flags, close anything else */
+    if (_stdin)
+        fcntl(_fd, F_SETFL, _flags);
+    else
+        close(_fd);
+}
+
+bool RawAudioSource::_fill() {
+    /* Move down partial frame */
+    memmove(_buffer.data(), _buffer.data() + _bufferStart, _bufferEnd - _bufferStart);
+    _bufferEnd -= _bufferStart;
+    _bufferStart = 0;
+
+    while (!_cancelled) {
+        ssize_t ret = ::read(_fd, _buffer.data() + _bufferEnd, _buffer.size() - _bufferEnd);
+
+        if (ret > 0) {
+            _bufferEnd += static_cast<size_t>(ret);
+            return true;
+        } else if (ret == 0) {
+            return false;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            /* Wait for data, waking periodically to check for cancel */
+            struct pollfd pfd = {_fd, POLLIN, 0};
+            if (poll(&pfd, 1, 100) < 0 && errno != EINTR)
+                throw ReadException("Reading raw audio: poll(): " + std::string(strerror(errno)));
+        } else if (errno != EINTR) {
+            throw ReadException("Reading raw audio: read(): " + std::string(strerror(errno)));
+        }
+    }
+
+    return false;
+}
+
+void RawAudioSource::read(std::vector<float> &samples) {
+    size_t sampleSize = (_format == Format::S16) ? sizeof(int16_t) : sizeof(float);
+    size_t frameSize = sampleSize * _channels;
+    size_t count = 0;
+
+    while (count < samples.size()) {
+        size_t frames = (_bufferEnd - _bufferStart) / frameSize;
+
+        if (frames == 0) {
+            if (!_fill())
+                break;
+            continue;
+        }
+
+        frames = std::min(frames, samples.size() - count);
+
+        /* Convert and mix multiple channels into one */
+        for (size_t i = 0; i < frames; i++) {
+            const uint8_t *frame = _buffer.data() + _bufferStart + i * frameSize;
+            float sum = 0;
+
+            for (unsigned int j = 0; j < _channels; j++) {
+                if (_format == Format::S16) {
+                    int16_t sample;
+                    memcpy(&sample, frame + j * sampleSize, sizeof(sample));
+                    sum += static_cast<float>(sample) / 32768.0f;
+                } else {
+                    float sample;
+                    memcpy(&sample, frame + j * sampleSize, sizeof(sample));
+                    sum += sample;
+                }
+            }
+
+            samples[count + i] = sum / static_cast<float>(_channels);
+        }
+
+        _bufferStart += frames * frameSize;
+        count += frames;
+    }
+
+    /* Resize samples buffer if we read less than requested */
+    if (count < samples.size())
+        samples.resize(count);
+}
+
+unsigned int RawAudioSource::getSampleRate() {
+    return _sampleRate;
+}
+
+void RawAudioSource::cancel() {
+    _cancelled = true;
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+#include "AudioSource.hpp"
+
+namespace Audio {
+
+/*
+ * Raw PCM source, reading interleaved samples in native byte order from a
+ * file, FIFO, or standard input ("-"). The stream is read with large
+ * non-blocking reads into a buffer, and multiple channels are mixed into one.
+ */
+class RawAudioSource : public AudioSource {
+  public:
+    enum class Format { S16,
+                        F32 };
+
+    /* Read buffer size in bytes */
+    static constexpr size_t BufferSize = 65536;
+
+    RawAudioSource(std::string path, Format format, unsigned int sampleRate, unsigned int channels);
+    ~RawAudioSource();
+
+    /* Read samples, blocking until all are read, or fewer at end of stream */
+    virtual void read(std::vector<float> &samples);
+    virtual unsigned int getSampleRate();
+    virtual void cancel();
+
+  private:
+    /* Read more of the stream into buffer, returns false at end of stream or on cancel */
+    bool _fill();
+
+    int _fd;
+    bool _stdin;
+    int _flags;
+
+    const Format _format;
+    const unsigned int _sampleRate;
+    const unsigned int _channels;
+
+    /* Buffered bytes, unread from _bufferStart to _bufferEnd */
+    std::vector<uint8_t> _buffer;
+    size_t _bufferStart = 0;
+    size_t _bufferEnd = 0;
+
+    std::atomic<bool> _cancelled;
+};
+
+std::string to_string(const RawAudioSource::Format &format);
+
+}
@@ -58,4 +58,13 @@ unsigned int WaveAudioSource::getSampleRate() {
     return static_cast<unsigned int>(_sfinfo.samplerate);
 }
 
+size_t WaveAudioSource::getLength() {
+    return static_cast<size_t>(_sfinfo.frames);
+}
+
+void WaveAudioSource::seek(size_t sample) {
+    if (sf_seek(_sndfile, static_cast<sf_count_t>(sample), SF_SEEK_SET) < 0)
+        throw ReadException("Seeking WAV file: sf_seek(): " + std::string(sf_strerror(_sndfile)));
+}
+
 }
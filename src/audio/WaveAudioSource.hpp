@@ -15,6 +15,11 @@ class WaveAudioSource : public AudioSource {
     virtual void read(std::vector<float> &samples);
     virtual unsigned int getSampleRate();
 
+    /* Get length in samples */
+    size_t getLength();
+    /* Seek to sample */
+    void seek(size_t sample);
+
   private:
     void _read_multi_channel(std::vector<float> &samples);
     void _read_single_channel(std::vector<float> &samples);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstdint>
+
+namespace Cache {
+
+/*
+ * Magnitude cache file format (little-endian)
+ *
+ *  Header (64 bytes)
+ *      char[8]         magic "APMCACHE"
+ *      uint32          version (1)
+ *      uint32          header size in bytes (64)
+ *      uint32          sample rate in Hz
+ *      uint32          DFT size
+ *      uint32          DFT window function (0 Hann, 1 Hamming, 2 Bartlett, 3 Rectangular)
+ *      uint32          samples overlap
+ *      uint32          bins per frame (DFT size / 2 + 1)
+ *      uint32          reserved
+ *      uint64          frame count
+ *      float32         quantized magnitude minimum in dB
+ *      float32         quantized magnitude maximum in dB
+ *      uint8[8]        reserved
+ *
+ *  Frames (frame count * bins per frame * 2 bytes)
+ *      uint16[bins]    quantized magnitudes, linear in dB between minimum and maximum
+ */
+
+struct MagnitudeCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t sampleRate;
+    uint32_t dftSize;
+    uint32_t windowFunction;
+    uint32_t samplesOverlap;
+    uint32_t bins;
+    uint32_t reserved0;
+    uint64_t frames;
+    float quantizedMagnitudeMin;
+    float quantizedMagnitudeMax;
+    uint8_t reserved1[8];
+};
+
+static_assert(sizeof(MagnitudeCacheHeader) == 64, "Unexpected magnitude cache header size.");
+
+static const char MagnitudeCacheMagic[8] = {'A', 'P', 'M', 'C', 'A', 'C', 'H', 'E'};
+static const uint32_t MagnitudeCacheVersion = 1;
+
+class OpenException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+class WriteException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+class FormatException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+}
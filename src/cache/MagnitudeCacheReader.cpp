@@ -0,0 +1,110 @@
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "spectrogram/SpectrumRenderer.hpp"
+
+#include "MagnitudeCacheReader.hpp"
+
+namespace Cache {
+
+MagnitudeCacheReader::MagnitudeCacheReader(std::string path) {
+    int fd;
+    struct stat st;
+
+    if ((fd = open(path.c_str(), O_RDONLY)) < 0)
+        throw OpenException("Error opening magnitude cache file: " + std::string(strerror(errno)));
+
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw OpenException("Error querying magnitude cache file: " + std::string(strerror(errno)));
+    }
+
+    if (static_cast<size_t>(st.st_size) < sizeof(MagnitudeCacheHeader)) {
+        close(fd);
+        throw FormatException("Magnitude cache file too short.");
+    }
+
+    /* Map whole file */
+    _mappingSize = static_cast<size_t>(st.st_size);
+    _mapping = mmap(nullptr, _mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (_mapping == MAP_FAILED) {
+        _mapping = nullptr;
+        throw OpenException("Error mapping magnitude cache file: " + std::string(strerror(errno)));
+    }
+
+    /* Frames are read front to back when rendering */
+    madvise(_mapping, _mappingSize, MADV_SEQUENTIAL);
+
+    _header = static_cast<const MagnitudeCacheHeader *>(_mapping);
+    _frames = reinterpret_cast<const uint16_t *>(static_cast<const uint8_t *>(_mapping) + _header->headerSize);
+
+    /* Validate header */
+    try {
+        if (memcmp(_header->magic, MagnitudeCacheMagic, sizeof(MagnitudeCacheMagic)) != 0)
+            throw FormatException("Invalid magnitude cache magic.");
+        if (_header->version != MagnitudeCacheVersion || _header->headerSize != sizeof(MagnitudeCacheHeader))
+            throw FormatException("Unsupported magnitude cache version.");
+        if (_header->bins != _header->dftSize / 2 + 1 || _header->windowFunction > static_cast<uint32_t>(DFT::RealDft::WindowFunction::Rectangular))
+            throw FormatException("Invalid magnitude cache DFT settings.");
+        if (_header->quantizedMagnitudeMin != Spectrogram::SpectrumRenderer::QuantizedMagnitudeMin || _header->quantizedMagnitudeMax != Spectrogram::SpectrumRenderer::QuantizedMagnitudeMax)
+            throw FormatException("Unsupported magnitude cache quantization range.");
+        if ((_mappingSize - _header->headerSize) / sizeof(uint16_t) / _header->bins < _header->frames)
+            throw FormatException("Magnitude cache file truncated.");
+    } catch (const FormatException &e) {
+        munmap(_mapping, _mappingSize);
+        _mapping = nullptr;
+        throw;
+    }
+}
+
+MagnitudeCacheReader::~MagnitudeCacheReader() {
+    if (_mapping)
+        munmap(_mapping, _mappingSize);
+}
+
+bool MagnitudeCacheReader::isMagnitudeCache(std::string path) {
+    char magic[sizeof(MagnitudeCacheMagic)];
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(magic, sizeof(magic)))
+        return false;
+
+    return memcmp(magic, MagnitudeCacheMagic, sizeof(MagnitudeCacheMagic)) == 0;
+}
+
+const uint16_t *MagnitudeCacheReader::getFrame(size_t index) {
+    return _frames + index * _header->bins;
+}
+
+size_t MagnitudeCacheReader::getFrames() {
+    return static_cast<size_t>(_header->frames);
+}
+
+size_t MagnitudeCacheReader::getBins() {
+    return _header->bins;
+}
+
+unsigned int MagnitudeCacheReader::getSampleRate() {
+    return _header->sampleRate;
+}
+
+unsigned int MagnitudeCacheReader::getDftSize() {
+    return _header->dftSize;
+}
+
+DFT::RealDft::WindowFunction MagnitudeCacheReader::getWindowFunction() {
+    return static_cast<DFT::RealDft::WindowFunction>(_header->windowFunction);
+}
+
+unsigned int MagnitudeCacheReader::getSamplesOverlap() {
+    return _header->samplesOverlap;
+}
+
+}
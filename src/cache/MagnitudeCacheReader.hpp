@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#include "dft/RealDft.hpp"
+#include "MagnitudeCache.hpp"
+
+namespace Cache {
+
+class MagnitudeCacheReader {
+  public:
+    MagnitudeCacheReader(std::string path);
+    ~MagnitudeCacheReader();
+
+    /* Check if file is a magnitude cache */
+    static bool isMagnitudeCache(std::string path);
+
+    /* Get frame of quantized magnitudes (DFT size / 2 + 1 bins) */
+    const uint16_t *getFrame(size_t index);
+
+    /* Get frame count and bins per frame */
+    size_t getFrames();
+    size_t getBins();
+
+    /* Get recorded audio and DFT settings */
+    unsigned int getSampleRate();
+    unsigned int getDftSize();
+    DFT::RealDft::WindowFunction getWindowFunction();
+    unsigned int getSamplesOverlap();
+
+  private:
+    /* Memory mapping of cache file */
+    void *_mapping = nullptr;
+    size_t _mappingSize = 0;
+
+    const MagnitudeCacheHeader *_header;
+    const uint16_t *_frames;
+};
+
+}
@@ -0,0 +1,52 @@
+#include <cstring>
+
+#include "spectrogram/SpectrumRenderer.hpp"
+
+#include "MagnitudeCacheWriter.hpp"
+
+namespace Cache {
+
+MagnitudeCacheWriter::MagnitudeCacheWriter(std::string path, unsigned int sampleRate, unsigned int dftSize, DFT::RealDft::WindowFunction wf, unsigned int samplesOverlap) : _header() {
+    _file.open(path, std::ios::binary | std::ios::trunc);
+    if (!_file)
+        throw OpenException("Error opening magnitude cache file: " + path);
+
+    memcpy(_header.magic, MagnitudeCacheMagic, sizeof(_header.magic));
+    _header.version = MagnitudeCacheVersion;
+    _header.headerSize = sizeof(MagnitudeCacheHeader);
+    _header.sampleRate = sampleRate;
+    _header.dftSize = dftSize;
+    _header.windowFunction = static_cast<uint32_t>(wf);
+    _header.samplesOverlap = samplesOverlap;
+    _header.bins = dftSize / 2 + 1;
+    _header.frames = 0;
+    _header.quantizedMagnitudeMin = Spectrogram::SpectrumRenderer::QuantizedMagnitudeMin;
+    _header.quantizedMagnitudeMax = Spectrogram::SpectrumRenderer::QuantizedMagnitudeMax;
+
+    /* Write header with zero frames, finalized in write() */
+    _file.write(reinterpret_cast<const char *>(&_header), sizeof(_header));
+    if (!_file)
+        throw WriteException("Error writing magnitude cache header.");
+}
+
+void MagnitudeCacheWriter::append(const std::vector<uint16_t> &magnitudes) {
+    if (magnitudes.size() != _header.bins)
+        throw FormatException("Magnitudes size does not match magnitude cache bins!");
+
+    _file.write(reinterpret_cast<const char *>(magnitudes.data()), static_cast<std::streamsize>(magnitudes.size() * sizeof(uint16_t)));
+    if (!_file)
+        throw WriteException("Error writing magnitude cache frame.");
+
+    _header.frames++;
+}
+
+void MagnitudeCacheWriter::write() {
+    /* Rewrite header with final frame count */
+    _file.seekp(0);
+    _file.write(reinterpret_cast<const char *>(&_header), sizeof(_header));
+    _file.flush();
+    if (!_file)
+        throw WriteException("Error finalizing magnitude cache header.");
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "dft/RealDft.hpp"
+#include "MagnitudeCache.hpp"
+
+namespace Cache {
+
+class MagnitudeCacheWriter {
+  public:
+    MagnitudeCacheWriter(std::string path, unsigned int sampleRate, unsigned int dftSize, DFT::RealDft::WindowFunction wf, unsigned int samplesOverlap);
+
+    /* Append a frame of quantized magnitudes (DFT size / 2 + 1 bins) */
+    void append(const std::vector<uint16_t> &magnitudes);
+
+    /* Finalize header and flush file */
+    void write();
+
+  private:
+    std::ofstream _file;
+    MagnitudeCacheHeader _header;
+};
+
+}
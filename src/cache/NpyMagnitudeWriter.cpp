@@ -0,0 +1,175 @@
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+#include "spectrogram/SpectrumRenderer.hpp"
+
+#include "NpyMagnitudeWriter.hpp"
+
+using namespace Spectrogram;
+
+namespace Cache {
+
+std::string to_string(const NpyMagnitudeWriter::Format &format) {
+    if (format == NpyMagnitudeWriter::Format::Power)
+        return "power";
+    else if (format == NpyMagnitudeWriter::Format::Magnitude)
+        return "magnitude";
+    else if (format == NpyMagnitudeWriter::Format::U16)
+        return "u16";
+    else if (format == NpyMagnitudeWriter::Format::U8)
+        return "u8";
+
+    return "";
+}
+
+constexpr size_t NpyMagnitudeWriter::HeaderSize;
+
+static size_t elementSize(NpyMagnitudeWriter::Format format) {
+    if (format == NpyMagnitudeWriter::Format::U16)
+        return sizeof(uint16_t);
+    else if (format == NpyMagnitudeWriter::Format::U8)
+        return sizeof(uint8_t);
+
+    return sizeof(float);
+}
+
+static std::string elementDescr(NpyMagnitudeWriter::Format format) {
+    if (format == NpyMagnitudeWriter::Format::U16)
+        return "<u2";
+    else if (format == NpyMagnitudeWriter::Format::U8)
+        return "|u1";
+
+    return "<f4";
+}
+
+NpyMagnitudeWriter::NpyMagnitudeWriter(std::string path, Format format, size_t bins, uint64_t rows, unsigned int sampleRate, unsigned int dftSize, unsigned int samplesOverlap) : _path(path), _format(format), _bins(bins), _rows(0), _headerRows(rows), _sampleRate(sampleRate), _dftSize(dftSize), _samplesOverlap(samplesOverlap), _row(bins * elementSize(format)) {
+    if (_path == "-") {
+        _stream = &std::cout;
+    } else {
+        _file.open(_path, std::ios::binary | std::ios::trunc);
+        if (!_file)
+            throw OpenException("Error opening NPY file: " + _path);
+        _stream = &_file;
+    }
+
+    /* Write header with the expected row count, finalized in write() */
+    _writeHeader();
+}
+
+void NpyMagnitudeWriter::_writeHeader() {
+    std::ostringstream dict;
+    dict << "{'descr': '" << elementDescr(_format) << "', 'fortran_order': False, 'shape': (" << _headerRows << ", " << _bins << "), }";
+
+    /* Timing and quantization, as a comment after the dictionary */
+    dict << " # sample_rate=" << _sampleRate << " dft_size=" << _dftSize << " samples_overlap=" << _samplesOverlap;
+    dict << " seconds_per_row=" << (static_cast<float>(_dftSize - _samplesOverlap) / static_cast<float>(_sampleRate));
+    if (_format == Format::U16 || _format == Format::U8)
+        dict << " db_scale=" << getScale(_format) << " db_offset=" << getOffset(_format);
+
+    if (dict.str().size() > HeaderSize - 11)
+        throw FormatException("NPY header does not fit in header size.");
+
+    /* Magic, version 1.0, and little-endian header length, then the dictionary padded with spaces to a newline */
+    std::string header("\x93NUMPY\x01\x00", 8);
+    uint16_t length = static_cast<uint16_t>(HeaderSize - 10);
+    header += static_cast<char>(length & 0xff);
+    header += static_cast<char>(length >> 8);
+    header += dict.str();
+    header.resize(HeaderSize - 1, ' ');
+    header += '\n';
+
+    _stream->write(header.data(), static_cast<std::streamsize>(header.size()));
+    if (!*_stream)
+        throw WriteException("Error writing NPY header.");
+}
+
+void NpyMagnitudeWriter::append(const std::vector<std::complex<float>> &dft) {
+    if (dft.size() != _bins)
+        throw FormatException("Spectrum size does not match NPY bins!");
+
+    if (_format == Format::Power || _format == Format::Magnitude) {
+        float *row = reinterpret_cast<float *>(_row.data());
+        for (size_t i = 0; i < _bins; i++)
+            row[i] = (_format == Format::Power) ? std::norm(dft[i]) : std::abs(dft[i]);
+    } else if (_format == Format::U16) {
+        uint16_t *row = reinterpret_cast<uint16_t *>(_row.data());
+        for (size_t i = 0; i < _bins; i++)
+            row[i] = SpectrumRenderer::quantize(10.0f * std::log10(std::norm(dft[i])));
+    } else {
+        /* Same dB range as U16, in 255 steps */
+        const float scale = 1.0f / getScale(Format::U8);
+        uint8_t *row = reinterpret_cast<uint8_t *>(_row.data());
+        for (size_t i = 0; i < _bins; i++) {
+            float magnitude = 10.0f * std::log10(std::norm(dft[i]));
+            if (!std::isfinite(magnitude)) {
+                row[i] = 0;
+                continue;
+            }
+
+            magnitude = std::max(std::min(magnitude, SpectrumRenderer::QuantizedMagnitudeMax), SpectrumRenderer::QuantizedMagnitudeMin);
+            row[i] = static_cast<uint8_t>(scale * (magnitude - SpectrumRenderer::QuantizedMagnitudeMin) + 0.5f);
+        }
+    }
+
+    _stream->write(_row.data(), static_cast<std::streamsize>(_row.size()));
+    if (!*_stream)
+        throw WriteException("Error writing NPY row.");
+
+    _rows++;
+}
+
+void NpyMagnitudeWriter::write() {
+    /* Rewrite header with final row count, which requires output that can seek */
+    if (_rows != _headerRows) {
+        if (_stream == &_file)
+            _file.seekp(0);
+        if (_stream != &_file || !_file)
+            throw WriteException("NPY row count does not match the header, and the output cannot seek to rewrite it.");
+
+        _headerRows = _rows;
+        _writeHeader();
+        _file.seekp(0, std::ios::end);
+    }
+
+    _stream->flush();
+    if (!*_stream)
+        throw WriteException("Error finalizing NPY file.");
+
+    if (_stream != &_file)
+        return;
+
+    /* Write index */
+    std::ofstream index(_path + ".txt", std::ios::trunc);
+    if (!index)
+        throw OpenException("Error opening NPY index: " + _path + ".txt");
+
+    index << "format " << to_string(_format) << "\n";
+    index << "rows " << _rows << "\n";
+    index << "bins " << _bins << "\n";
+    index << "sample_rate " << _sampleRate << "\n";
+    index << "dft_size " << _dftSize << "\n";
+    index << "samples_overlap " << _samplesOverlap << "\n";
+    index << "seconds_per_row " << (static_cast<float>(_dftSize - _samplesOverlap) / static_cast<float>(_sampleRate)) << "\n";
+    if (_format == Format::U16 || _format == Format::U8) {
+        index << "db_scale " << getScale(_format) << "\n";
+        index << "db_offset " << getOffset(_format) << "\n";
+    }
+
+    if (!index)
+        throw WriteException("Error writing NPY index.");
+}
+
+float NpyMagnitudeWriter::getScale(Format format) {
+    float steps = (format == Format::U8) ? 255.0f : 65535.0f;
+
+    return (SpectrumRenderer::QuantizedMagnitudeMax - SpectrumRenderer::QuantizedMagnitudeMin) / steps;
+}
+
+float NpyMagnitudeWriter::getOffset(Format) {
+    return SpectrumRenderer::QuantizedMagnitudeMin;
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <fstream>
+#include <ostream>
+
+#include "MagnitudeCache.hpp"
+
+namespace Cache {
+
+/*
+ * Streaming writer of spectrum frames as a NumPy NPY file (version 1.0), a
+ * two-dimensional little-endian array of rows by bins in C order.
+ *
+ * Frames are converted and written as they are appended, so memory use does
+ * not grow with the input. The header is padded to a fixed HeaderSize and
+ * rewritten with the final row count on write(). On output that cannot seek,
+ * such as standard output ("-") or a pipe, the header keeps the row count
+ * given up front, so it must be known, and write() fails if fewer or more
+ * rows were appended.
+ *
+ * The frame timing, and the dB scale and offset of quantized formats, follow
+ * the header dictionary as a comment, as np.load() rejects a dictionary with
+ * any other keys, e.g.
+ *
+ *      {'descr': '<u2', 'fortran_order': False, 'shape': (100, 513), } # sample_rate=48000 dft_size=1024 ...
+ *
+ * Formats:
+ *      Power       float32 |X|^2
+ *      Magnitude   float32 |X|
+ *      U16         uint16 quantized magnitude in dB, dB = offset + scale * value
+ *      U8          uint8 quantized magnitude in dB, dB = offset + scale * value
+ *
+ * For file output, a plain text index of the array geometry, timing, and
+ * quantization scale is written alongside to <path>.txt.
+ */
+class NpyMagnitudeWriter {
+  public:
+    enum class Format { Power,
+                        Magnitude,
+                        U16,
+                        U8 };
+
+    /* Header size in bytes, including magic and padding */
+    static constexpr size_t HeaderSize = 256;
+
+    NpyMagnitudeWriter(std::string path, Format format, size_t bins, uint64_t rows, unsigned int sampleRate, unsigned int dftSize, unsigned int samplesOverlap);
+
+    /* Append a frame (bins) */
+    void append(const std::vector<std::complex<float>> &dft);
+
+    /* Finalize header and index, and flush output */
+    void write();
+
+    /* Quantization scale and offset in dB of a quantized format */
+    static float getScale(Format format);
+    static float getOffset(Format format);
+
+  private:
+    void _writeHeader();
+
+    const std::string _path;
+    const Format _format;
+    const size_t _bins;
+    uint64_t _rows, _headerRows;
+    const unsigned int _sampleRate, _dftSize, _samplesOverlap;
+
+    /* Output file, or standard output */
+    std::ofstream _file;
+    std::ostream *_stream;
+
+    /* Converted row */
+    std::vector<char> _row;
+};
+
+std::string to_string(const NpyMagnitudeWriter::Format &format);
+
+}
@@ -0,0 +1,92 @@
+#include "ComplexDft.hpp"
+
+namespace DFT {
+
+ComplexDft::ComplexDft(unsigned int N, RealDft::WindowFunction wf) : _N(N), _windowFunction(wf) {
+    setSize(_N);
+}
+
+ComplexDft::~ComplexDft() {
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+
+    if (_plan)
+        fftwf_destroy_plan(_plan);
+    if (_dft)
+        fftwf_free(_dft);
+    if (_windowedSamples)
+        fftwf_free(_windowedSamples);
+}
+
+void ComplexDft::compute(std::vector<std::complex<float>> &dft, const std::vector<std::complex<float>> &samples) {
+    /* Assert sample buffer size */
+    if (samples.size() != _N)
+        throw SizeMismatchException("Samples size does not match DFT size!");
+
+    /* Size dft buffer correctly */
+    dft.resize(_N);
+
+    /* Window samples first */
+    for (unsigned int n = 0; n < _N; n++) {
+        _windowedSamples[n][0] = samples[n].real() * _window[n];
+        _windowedSamples[n][1] = samples[n].imag() * _window[n];
+    }
+
+    /* Execute DFT */
+    fftwf_execute(_plan);
+
+    /* Copy DFT, shifting negative frequencies first */
+    for (unsigned int n = 0; n < _N; n++) {
+        unsigned int k = (n + _N / 2) % _N;
+        dft[n] = std::complex<float>(_dft[k][0], _dft[k][1]);
+    }
+}
+
+unsigned int ComplexDft::getSize() {
+    return _N;
+}
+
+void ComplexDft::setSize(unsigned int N) {
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+
+    /* Deallocate FFTW resources we are changing */
+    if (_plan)
+        fftwf_destroy_plan(_plan);
+    if (_dft)
+        fftwf_free(_dft);
+    if (_windowedSamples)
+        fftwf_free(_windowedSamples);
+
+    /* Resize window */
+    _window.resize(N);
+    /* Recalculate window function */
+    calculateWindow(_window, _windowFunction);
+
+    /* Allocate windowed samples buffer */
+    _windowedSamples = fftwf_alloc_complex(N);
+    if (_windowedSamples == nullptr)
+        throw AllocationException("Allocating sample memory.");
+
+    /* Allocate DFT buffer */
+    _dft = fftwf_alloc_complex(N);
+    if (_dft == nullptr)
+        throw AllocationException("Allocating DFT memory.");
+
+    /* Rebuild our plan */
+    _plan = fftwf_plan_dft_1d(static_cast<int>(N), _windowedSamples, _dft, FFTW_FORWARD, FFTW_MEASURE);
+    if (_plan == nullptr)
+        throw AllocationException("Creating FFTW plan.");
+
+    /* Update N */
+    _N = N;
+}
+
+RealDft::WindowFunction ComplexDft::getWindowFunction() {
+    return _windowFunction;
+}
+
+void ComplexDft::setWindowFunction(RealDft::WindowFunction wf) {
+    _windowFunction = wf;
+    calculateWindow(_window, _windowFunction);
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include <fftw3.h>
+
+#include "RealDft.hpp"
+
+namespace DFT {
+
+class ComplexDft {
+  public:
+    ComplexDft(unsigned int N, RealDft::WindowFunction wf);
+    ~ComplexDft();
+
+    /* Compute new DFT based on complex samples, ordered from -fs/2 to +fs/2 */
+    void compute(std::vector<std::complex<float>> &dft, const std::vector<std::complex<float>> &samples);
+
+    /* Get/Set DFT Size */
+    unsigned int getSize();
+    void setSize(unsigned int N);
+
+    /* Get/Set Window Function */
+    RealDft::WindowFunction getWindowFunction();
+    void setWindowFunction(RealDft::WindowFunction wf);
+
+  private:
+    /* DFT Size */
+    unsigned int _N;
+    /* Window Function */
+    RealDft::WindowFunction _windowFunction;
+    /* Window */
+    std::vector<float> _window;
+    /* Windowed Samples */
+    fftwf_complex *_windowedSamples = nullptr;
+    /* Complex DFT */
+    fftwf_complex *_dft = nullptr;
+    /* FFTW Plan */
+    fftwf_plan _plan = nullptr;
+};
+
+}
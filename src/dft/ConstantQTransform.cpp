@@ -0,0 +1,145 @@
+#include <cmath>
+#include <algorithm>
+
+#include "ConstantQTransform.hpp"
+#include "ComplexDft.hpp"
+
+namespace DFT {
+
+constexpr float ConstantQTransform::KernelThreshold;
+
+/* Quality factor of a constant-Q bin: center frequency over bandwidth */
+static float qualityFactor(unsigned int binsPerOctave) {
+    return 1.0f / (std::pow(2.0f, 1.0f / static_cast<float>(binsPerOctave)) - 1.0f);
+}
+
+ConstantQTransform::ConstantQTransform(unsigned int N, RealDft::WindowFunction wf, unsigned int sampleRate, unsigned int binsPerOctave, float minFrequency) : _N(N), _windowFunction(wf), _sampleRate(sampleRate), _binsPerOctave(binsPerOctave), _minFrequency(minFrequency), _realDft(N, RealDft::WindowFunction::Rectangular) {
+    _update();
+}
+
+void ConstantQTransform::compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples) {
+    /* Assert sample buffer size */
+    if (samples.size() != _N)
+        throw SizeMismatchException("Samples size does not match constant-Q frame size!");
+
+    /* Real DFT of unwindowed frame, the window is part of the kernels */
+    _realDft.compute(_dft, samples);
+
+    /* Size output buffer correctly */
+    size_t bins = _offsets.size() - 1;
+    dft.resize(bins);
+
+    /* Sparse multiply with spectral kernels */
+    for (size_t k = 0; k < bins; k++) {
+        std::complex<float> sum = 0.0f;
+        for (uint32_t e = _offsets[k]; e < _offsets[k + 1]; e++)
+            sum += _dft[_indices[e]] * _kernels[e];
+        dft[k] = sum;
+    }
+}
+
+unsigned int ConstantQTransform::getSize() {
+    return _N;
+}
+
+void ConstantQTransform::setSize(unsigned int N) {
+    _N = N;
+    _realDft.setSize(N);
+    _update();
+}
+
+RealDft::WindowFunction ConstantQTransform::getWindowFunction() {
+    return _windowFunction;
+}
+
+void ConstantQTransform::setWindowFunction(RealDft::WindowFunction wf) {
+    _windowFunction = wf;
+    _update();
+}
+
+unsigned int ConstantQTransform::getBinsPerOctave() {
+    return _binsPerOctave;
+}
+
+void ConstantQTransform::setBinsPerOctave(unsigned int binsPerOctave) {
+    _binsPerOctave = binsPerOctave;
+    _update();
+}
+
+float ConstantQTransform::getMinFrequency() {
+    return _minFrequency;
+}
+
+void ConstantQTransform::setMinFrequency(float frequency) {
+    _minFrequency = frequency;
+    _update();
+}
+
+unsigned int ConstantQTransform::getBins() {
+    return static_cast<unsigned int>(_offsets.size() - 1);
+}
+
+float ConstantQTransform::getMinFrequency(unsigned int N, unsigned int sampleRate, unsigned int binsPerOctave, float minFrequency) {
+    float Q = qualityFactor(binsPerOctave);
+
+    return std::max(minFrequency, Q * static_cast<float>(sampleRate) / static_cast<float>(N));
+}
+
+unsigned int ConstantQTransform::getBins(unsigned int N, unsigned int sampleRate, unsigned int binsPerOctave, float minFrequency) {
+    float fmin = getMinFrequency(N, sampleRate, binsPerOctave, minFrequency);
+    float octaves = std::log2((static_cast<float>(sampleRate) / 2.0f) / fmin);
+
+    return std::max(1U, static_cast<unsigned int>(std::ceil(static_cast<float>(binsPerOctave) * octaves)));
+}
+
+void ConstantQTransform::_update() {
+    float Q = qualityFactor(_binsPerOctave);
+    float fmin = getMinFrequency(_N, _sampleRate, _binsPerOctave, _minFrequency);
+    unsigned int bins = getBins(_N, _sampleRate, _binsPerOctave, _minFrequency);
+
+    ComplexDft complexDft(_N, RealDft::WindowFunction::Rectangular);
+    std::vector<std::complex<float>> temporalKernel(_N);
+    std::vector<std::complex<float>> spectralKernel;
+    std::vector<float> window;
+
+    _offsets.assign(1, 0);
+    _indices.clear();
+    _kernels.clear();
+
+    for (unsigned int k = 0; k < bins; k++) {
+        float fk = fmin * std::pow(2.0f, static_cast<float>(k) / static_cast<float>(_binsPerOctave));
+        unsigned int Nk = std::min(_N, static_cast<unsigned int>(std::ceil(Q * static_cast<float>(_sampleRate) / fk)));
+        unsigned int offset = (_N - Nk) / 2;
+
+        /* Windowed complex exponential of length Nk, centered in the frame and scaled to match an N point DFT */
+        window.resize(Nk);
+        calculateWindow(window, _windowFunction);
+
+        std::fill(temporalKernel.begin(), temporalKernel.end(), 0.0f);
+        for (unsigned int n = 0; n < Nk; n++) {
+            float phase = 2.0f * static_cast<float>(M_PI) * fk * static_cast<float>(n) / static_cast<float>(_sampleRate);
+            temporalKernel[offset + n] = std::polar(window[n] * static_cast<float>(_N) / static_cast<float>(Nk), phase);
+        }
+
+        /* Spectral kernel, unshifted to DFT bin order */
+        complexDft.compute(spectralKernel, temporalKernel);
+
+        float peak = 0.0f;
+        for (unsigned int j = 0; j <= _N / 2; j++)
+            peak = std::max(peak, std::abs(spectralKernel[(j + _N / 2) % _N]));
+
+        /* Keep significant non-negative frequency entries, conjugated and normalized for Parseval */
+        for (unsigned int j = 0; j <= _N / 2; j++) {
+            std::complex<float> value = spectralKernel[(j + _N / 2) % _N];
+            if (std::abs(value) < KernelThreshold * peak)
+                continue;
+
+            _indices.push_back(j);
+            _kernels.push_back(std::conj(value) / static_cast<float>(_N));
+        }
+
+        _offsets.push_back(static_cast<uint32_t>(_indices.size()));
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <cstdint>
+
+#include "SpectrumEngine.hpp"
+#include "RealDft.hpp"
+
+namespace DFT {
+
+/*
+ * Constant-Q transform by the sparse kernel method (Brown and Puckette).
+ *
+ * Each bin k is the inner product of the frame with a windowed complex
+ * exponential at f_k = f_min * 2^(k / B) and length Q * fs / f_k, centered in
+ * the frame. The spectral kernels (DFT of those exponentials) are precomputed
+ * when the configuration changes and thresholded into a sparse table, so a
+ * frame costs one real DFT plus a sparse multiply. Bins are ordered from low to
+ * high frequency, and magnitudes are scaled to match a real DFT of the frame
+ * size.
+ */
+class ConstantQTransform : public SpectrumEngine {
+  public:
+    /* Relative magnitude below which spectral kernel entries are dropped */
+    static constexpr float KernelThreshold = 0.005f;
+
+    ConstantQTransform(unsigned int N, RealDft::WindowFunction wf, unsigned int sampleRate, unsigned int binsPerOctave, float minFrequency);
+
+    /* Compute constant-Q bins of a frame of samples */
+    virtual void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples);
+
+    /* Get/Set Frame Size */
+    virtual unsigned int getSize();
+    void setSize(unsigned int N);
+
+    /* Get/Set Window Function */
+    RealDft::WindowFunction getWindowFunction();
+    void setWindowFunction(RealDft::WindowFunction wf);
+
+    /* Get/Set Bins per Octave */
+    unsigned int getBinsPerOctave();
+    void setBinsPerOctave(unsigned int binsPerOctave);
+
+    /* Get/Set Requested Minimum Frequency in Hz */
+    float getMinFrequency();
+    void setMinFrequency(float frequency);
+
+    /* Get number of bins */
+    unsigned int getBins();
+
+    /* Lowest bin frequency in Hz, raised from the requested minimum until its kernel fits in N samples */
+    static float getMinFrequency(unsigned int N, unsigned int sampleRate, unsigned int binsPerOctave, float minFrequency);
+    /* Number of bins from the lowest bin frequency up to Nyquist */
+    static unsigned int getBins(unsigned int N, unsigned int sampleRate, unsigned int binsPerOctave, float minFrequency);
+
+  private:
+    void _update();
+
+    /* Configuration */
+    unsigned int _N;
+    RealDft::WindowFunction _windowFunction;
+    const unsigned int _sampleRate;
+    unsigned int _binsPerOctave;
+    float _minFrequency;
+
+    /* Real DFT of the unwindowed frame */
+    RealDft _realDft;
+    std::vector<std::complex<float>> _dft;
+
+    /* Sparse spectral kernels, bin k spans entries _offsets[k] to _offsets[k + 1] */
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _indices;
+    std::vector<std::complex<float>> _kernels;
+};
+
+}
@@ -0,0 +1,87 @@
+#include <cmath>
+
+#include "GoertzelBank.hpp"
+
+namespace DFT {
+
+GoertzelBank::GoertzelBank(unsigned int N, RealDft::WindowFunction wf, unsigned int sampleRate, const std::vector<float> &frequencies) : _N(N), _windowFunction(wf), _frequencies(frequencies) {
+    size_t tones = _frequencies.size();
+
+    _coefficients.resize(tones);
+    _cosines.resize(tones);
+    _sines.resize(tones);
+    _s1.resize(tones);
+    _s2.resize(tones);
+
+    for (size_t i = 0; i < tones; i++) {
+        double w = 2.0 * M_PI * static_cast<double>(_frequencies[i]) / static_cast<double>(sampleRate);
+        _coefficients[i] = 2.0 * std::cos(w);
+        _cosines[i] = std::cos(w);
+        _sines[i] = std::sin(w);
+    }
+
+    setSize(_N);
+}
+
+void GoertzelBank::compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples) {
+    /* Assert sample buffer size */
+    if (samples.size() != _N)
+        throw SizeMismatchException("Samples size does not match Goertzel frame size!");
+
+    size_t tones = _frequencies.size();
+
+    /* Window samples first */
+    for (unsigned int n = 0; n < _N; n++)
+        _windowedSamples[n] = static_cast<double>(samples[n] * _window[n]);
+
+    /* Run recursion s = x + 2 cos(w) s1 - s2 for all tones, sample by sample */
+    double *s1 = _s1.data();
+    double *s2 = _s2.data();
+    const double *coefficients = _coefficients.data();
+
+    for (size_t i = 0; i < tones; i++)
+        s1[i] = s2[i] = 0.0;
+
+    for (unsigned int n = 0; n < _N; n++) {
+        double x = _windowedSamples[n];
+        for (size_t i = 0; i < tones; i++) {
+            double s = x + coefficients[i] * s1[i] - s2[i];
+            s2[i] = s1[i];
+            s1[i] = s;
+        }
+    }
+
+    /* Size dft buffer correctly */
+    dft.resize(tones);
+
+    /* Final step, up to a phase rotation that does not affect magnitude */
+    for (size_t i = 0; i < tones; i++)
+        dft[i] = std::complex<float>(static_cast<float>(s1[i] - _cosines[i] * s2[i]), static_cast<float>(_sines[i] * s2[i]));
+}
+
+unsigned int GoertzelBank::getSize() {
+    return _N;
+}
+
+void GoertzelBank::setSize(unsigned int N) {
+    _window.resize(N);
+    calculateWindow(_window, _windowFunction);
+    _windowedSamples.resize(N);
+
+    _N = N;
+}
+
+RealDft::WindowFunction GoertzelBank::getWindowFunction() {
+    return _windowFunction;
+}
+
+void GoertzelBank::setWindowFunction(RealDft::WindowFunction wf) {
+    _windowFunction = wf;
+    calculateWindow(_window, _windowFunction);
+}
+
+const std::vector<float> &GoertzelBank::getFrequencies() {
+    return _frequencies;
+}
+
+}
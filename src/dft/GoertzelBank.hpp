@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include "SpectrumEngine.hpp"
+#include "RealDft.hpp"
+
+namespace DFT {
+
+/*
+ * Bank of Goertzel filters evaluating the DFT of a frame at a list of
+ * frequencies. The filter states are kept as arrays across the tones, so the
+ * per-sample recursion runs over all tones in one vectorizable loop, and the
+ * cost scales with the number of tones rather than the frame size. Outputs are
+ * ordered as the tone list, and scaled as a real DFT of the frame.
+ */
+class GoertzelBank : public SpectrumEngine {
+  public:
+    GoertzelBank(unsigned int N, RealDft::WindowFunction wf, unsigned int sampleRate, const std::vector<float> &frequencies);
+
+    /* Compute DFT of a frame of samples at each tone frequency */
+    virtual void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples);
+
+    /* Get/Set Frame Size */
+    virtual unsigned int getSize();
+    void setSize(unsigned int N);
+
+    /* Get/Set Window Function */
+    RealDft::WindowFunction getWindowFunction();
+    void setWindowFunction(RealDft::WindowFunction wf);
+
+    /* Get tone frequencies in Hz */
+    const std::vector<float> &getFrequencies();
+
+  private:
+    /* Frame Size */
+    unsigned int _N;
+    /* Window Function */
+    RealDft::WindowFunction _windowFunction;
+    /* Window */
+    std::vector<float> _window;
+    /* Windowed Samples */
+    std::vector<double> _windowedSamples;
+
+    /* Tone frequencies */
+    const std::vector<float> _frequencies;
+
+    /* Per tone recursion coefficient (2 cos w), output rotation (cos w, sin w), and filter state */
+    std::vector<double> _coefficients;
+    std::vector<double> _cosines;
+    std::vector<double> _sines;
+    std::vector<double> _s1;
+    std::vector<double> _s2;
+};
+
+}
@@ -0,0 +1,250 @@
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include "MultitaperDft.hpp"
+
+namespace DFT {
+
+constexpr unsigned int MultitaperDft::AdaptiveIterations;
+
+/* Count eigenvalues of the symmetric tridiagonal matrix (diagonal, offDiagonal squared) below x */
+static size_t countEigenvalues(const std::vector<double> &diagonal, const std::vector<double> &offDiagonalSquared, double x) {
+    size_t count = 0;
+    double q = 1.0;
+
+    for (size_t i = 0; i < diagonal.size(); i++) {
+        q = diagonal[i] - x - ((i > 0) ? offDiagonalSquared[i] / q : 0.0);
+        if (q == 0.0)
+            q = std::numeric_limits<double>::epsilon();
+        if (q < 0.0)
+            count++;
+    }
+
+    return count;
+}
+
+/*
+ * Calculate K DPSS tapers of size N with half bandwidth W = NW / N, as the
+ * eigenvectors of the largest eigenvalues of the commuting tridiagonal matrix,
+ * by bisection and inverse iteration. Tapers are normalized to unit energy,
+ * and their spectral concentrations in [-W, W] are measured from a zero padded
+ * DFT.
+ */
+static void calculateTapers(std::vector<float> &tapers, std::vector<float> &concentrations, unsigned int N, unsigned int K, double NW) {
+    double W = NW / static_cast<double>(N);
+
+    std::vector<double> diagonal(N), offDiagonal(N, 0.0), offDiagonalSquared(N, 0.0);
+    for (unsigned int n = 0; n < N; n++) {
+        double t = (static_cast<double>(N) - 1.0 - 2.0 * static_cast<double>(n)) / 2.0;
+        diagonal[n] = t * t * std::cos(2.0 * M_PI * W);
+        if (n > 0) {
+            offDiagonal[n] = static_cast<double>(n) * static_cast<double>(N - n) / 2.0;
+            offDiagonalSquared[n] = offDiagonal[n] * offDiagonal[n];
+        }
+    }
+
+    /* Gershgorin bounds on the eigenvalues */
+    double lower = std::numeric_limits<double>::max(), upper = std::numeric_limits<double>::lowest();
+    for (unsigned int n = 0; n < N; n++) {
+        double radius = offDiagonal[n] + ((n + 1 < N) ? offDiagonal[n + 1] : 0.0);
+        lower = std::min(lower, diagonal[n] - radius);
+        upper = std::max(upper, diagonal[n] + radius);
+    }
+
+    tapers.resize(static_cast<size_t>(K) * N);
+    concentrations.resize(K);
+
+    std::vector<double> x(N), cp(N), dp(N);
+    RealDft paddedDft(4 * N, RealDft::WindowFunction::Rectangular);
+    std::vector<float> padded(4 * N, 0.0f);
+    std::vector<std::complex<float>> spectrum;
+
+    for (unsigned int k = 0; k < K; k++) {
+        /* Bisect for the k-th largest eigenvalue */
+        size_t index = N - 1 - k;
+        double lo = lower, hi = upper;
+        for (unsigned int i = 0; i < 128 && (hi - lo) > std::numeric_limits<double>::epsilon() * std::max(std::abs(lo), std::abs(hi)); i++) {
+            double mid = (lo + hi) / 2.0;
+            if (countEigenvalues(diagonal, offDiagonalSquared, mid) <= index)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        double eigenvalue = (lo + hi) / 2.0;
+
+        /* Inverse iteration, solving (T - eigenvalue I) x = x with the Thomas algorithm */
+        for (unsigned int n = 0; n < N; n++)
+            x[n] = 1.0 + static_cast<double>(n) / static_cast<double>(N);
+
+        for (unsigned int iteration = 0; iteration < 3; iteration++) {
+            double tiny = std::numeric_limits<double>::epsilon() * std::max(std::abs(lower), std::abs(upper));
+
+            for (unsigned int n = 0; n < N; n++) {
+                double m = diagonal[n] - eigenvalue - ((n > 0) ? offDiagonal[n] * cp[n - 1] : 0.0);
+                if (std::abs(m) < tiny)
+                    m = tiny;
+                cp[n] = ((n + 1 < N) ? offDiagonal[n + 1] : 0.0) / m;
+                dp[n] = (x[n] - ((n > 0) ? offDiagonal[n] * dp[n - 1] : 0.0)) / m;
+            }
+
+            x[N - 1] = dp[N - 1];
+            for (unsigned int n = N - 1; n-- > 0;)
+                x[n] = dp[n] - cp[n] * x[n + 1];
+
+            double norm = 0.0;
+            for (unsigned int n = 0; n < N; n++)
+                norm += x[n] * x[n];
+            norm = std::sqrt(norm);
+            for (unsigned int n = 0; n < N; n++)
+                x[n] /= norm;
+        }
+
+        /* Fix sign: symmetric tapers sum positive, antisymmetric tapers start positive */
+        double polarity = 0.0;
+        for (unsigned int n = 0; n < N; n++)
+            polarity += x[n] * ((k % 2 == 0) ? 1.0 : (static_cast<double>(N) - 1.0 - 2.0 * static_cast<double>(n)));
+        double sign = (polarity < 0.0) ? -1.0 : 1.0;
+
+        float *taper = tapers.data() + static_cast<size_t>(k) * N;
+        for (unsigned int n = 0; n < N; n++)
+            taper[n] = static_cast<float>(sign * x[n]);
+
+        /* Spectral concentration, energy within [-W, W] over total energy */
+        std::copy(taper, taper + N, padded.begin());
+        paddedDft.compute(spectrum, padded);
+
+        size_t band = static_cast<size_t>(W * 4.0 * static_cast<double>(N));
+        double inBand = std::norm(spectrum[0]), total = 0.0;
+        for (size_t j = 1; j <= band; j++)
+            inBand += 2.0 * static_cast<double>(std::norm(spectrum[j]));
+        for (unsigned int n = 0; n < N; n++)
+            total += static_cast<double>(taper[n]) * static_cast<double>(taper[n]);
+        concentrations[k] = static_cast<float>(std::min(inBand / (4.0 * static_cast<double>(N) * total), 1.0));
+    }
+}
+
+MultitaperDft::MultitaperDft(unsigned int N, unsigned int tapers) : _N(N), _tapers(tapers) {
+    _update(_N, _tapers);
+}
+
+MultitaperDft::~MultitaperDft() {
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+
+    if (_plan)
+        fftwf_destroy_plan(_plan);
+    if (_dft)
+        fftwf_free(_dft);
+    if (_taperedSamples)
+        fftwf_free(_taperedSamples);
+}
+
+void MultitaperDft::compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples) {
+    /* Assert sample buffer size */
+    if (samples.size() != _N)
+        throw SizeMismatchException("Samples size does not match DFT size!");
+
+    size_t bins = _N / 2 + 1;
+
+    /* Taper samples with each taper */
+    for (unsigned int k = 0; k < _tapers; k++) {
+        const float *taper = _taperWindows.data() + static_cast<size_t>(k) * _N;
+        float *tapered = _taperedSamples + static_cast<size_t>(k) * _N;
+        for (unsigned int n = 0; n < _N; n++)
+            tapered[n] = samples[n] * taper[n];
+    }
+
+    /* Execute batched DFTs */
+    fftwf_execute(_plan);
+
+    /* Eigenspectra */
+    for (size_t i = 0; i < static_cast<size_t>(_tapers) * bins; i++)
+        _power[i] = _dft[i][0] * _dft[i][0] + _dft[i][1] * _dft[i][1];
+
+    /* Broadband noise power in eigenspectrum units, from the sample variance and taper energy */
+    float variance = 0.0f;
+    for (unsigned int n = 0; n < _N; n++)
+        variance += samples[n] * samples[n];
+    float noise = variance / static_cast<float>(_N) * (3.0f * static_cast<float>(_N) / 8.0f);
+
+    /* Size dft buffer correctly */
+    dft.resize(bins);
+
+    for (size_t f = 0; f < bins; f++) {
+        /* Start from the average of the two best concentrated eigenspectra */
+        float estimate = (_tapers > 1) ? (_power[f] + _power[bins + f]) / 2.0f : _power[f];
+
+        /* Iterate adaptive weights, downweighting tapers that leak broadband power */
+        for (unsigned int iteration = 0; iteration < AdaptiveIterations && _tapers > 1; iteration++) {
+            float numerator = 0.0f, denominator = 0.0f;
+            for (unsigned int k = 0; k < _tapers; k++) {
+                float lambda = _concentrations[k];
+                float d = std::sqrt(lambda) * estimate / (lambda * estimate + (1.0f - lambda) * noise + std::numeric_limits<float>::min());
+                numerator += d * d * _power[k * bins + f];
+                denominator += d * d;
+            }
+            estimate = (denominator > 0.0f) ? numerator / denominator : 0.0f;
+        }
+
+        dft[f] = std::complex<float>(std::sqrt(estimate), 0.0f);
+    }
+}
+
+unsigned int MultitaperDft::getSize() {
+    return _N;
+}
+
+void MultitaperDft::setSize(unsigned int N) {
+    _update(N, _tapers);
+}
+
+unsigned int MultitaperDft::getTapers() {
+    return _tapers;
+}
+
+void MultitaperDft::setTapers(unsigned int tapers) {
+    _update(_N, tapers);
+}
+
+void MultitaperDft::_update(unsigned int N, unsigned int tapers) {
+    /* Precompute tapers, scaled to the energy of a Hann window */
+    calculateTapers(_taperWindows, _concentrations, N, tapers, (static_cast<double>(tapers) + 1.0) / 2.0);
+
+    float scale = std::sqrt(3.0f * static_cast<float>(N) / 8.0f);
+    for (float &value : _taperWindows)
+        value *= scale;
+
+    _power.resize(static_cast<size_t>(tapers) * (N / 2 + 1));
+
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+
+    /* Deallocate FFTW resources we are changing */
+    if (_plan)
+        fftwf_destroy_plan(_plan);
+    if (_dft)
+        fftwf_free(_dft);
+    if (_taperedSamples)
+        fftwf_free(_taperedSamples);
+
+    /* Allocate tapered samples buffer */
+    _taperedSamples = fftwf_alloc_real(static_cast<size_t>(tapers) * N);
+    if (_taperedSamples == nullptr)
+        throw AllocationException("Allocating sample memory.");
+
+    /* Allocate DFT buffer */
+    _dft = fftwf_alloc_complex(static_cast<size_t>(tapers) * (N / 2 + 1));
+    if (_dft == nullptr)
+        throw AllocationException("Allocating DFT memory.");
+
+    /* Build batched plan, one real DFT per taper */
+    int n = static_cast<int>(N);
+    _plan = fftwf_plan_many_dft_r2c(1, &n, static_cast<int>(tapers), _taperedSamples, nullptr, 1, n, _dft, nullptr, 1, n / 2 + 1, FFTW_MEASURE);
+    if (_plan == nullptr)
+        throw AllocationException("Creating FFTW plan.");
+
+    /* Update N and tapers */
+    _N = N;
+    _tapers = tapers;
+}
+
+}
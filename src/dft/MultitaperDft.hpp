@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include <fftw3.h>
+
+#include "SpectrumEngine.hpp"
+#include "RealDft.hpp"
+
+namespace DFT {
+
+/*
+ * Multitaper spectral estimate with discrete prolate spheroidal sequence (DPSS)
+ * tapers.
+ *
+ * K tapers with time-bandwidth product NW = (K + 1) / 2 are precomputed when the
+ * size changes, and the K tapered DFTs of a frame run as one batched FFTW plan.
+ * The K eigenspectra are combined with Thomson's adaptive weights. Outputs are
+ * real square roots of the power estimate, with the tapers scaled to the
+ * energy of a Hann window of the same size, so the noise floor matches the DFT
+ * engine.
+ */
+class MultitaperDft : public SpectrumEngine {
+  public:
+    /* Adaptive weighting iterations */
+    static constexpr unsigned int AdaptiveIterations = 3;
+
+    MultitaperDft(unsigned int N, unsigned int tapers);
+    ~MultitaperDft();
+
+    /* Compute multitaper spectrum of a frame of samples */
+    virtual void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples);
+
+    /* Get/Set DFT Size */
+    virtual unsigned int getSize();
+    void setSize(unsigned int N);
+
+    /* Get/Set Number of Tapers */
+    unsigned int getTapers();
+    void setTapers(unsigned int tapers);
+
+  private:
+    void _update(unsigned int N, unsigned int tapers);
+
+    /* DFT Size */
+    unsigned int _N;
+    /* Number of tapers */
+    unsigned int _tapers;
+
+    /* Tapers, back to back, and their spectral concentrations */
+    std::vector<float> _taperWindows;
+    std::vector<float> _concentrations;
+
+    /* Tapered samples, back to back */
+    float *_taperedSamples = nullptr;
+    /* Tapered DFTs, back to back */
+    fftwf_complex *_dft = nullptr;
+    /* Batched FFTW Plan */
+    fftwf_plan _plan = nullptr;
+
+    /* Scratch eigenspectra */
+    std::vector<float> _power;
+};
+
+}
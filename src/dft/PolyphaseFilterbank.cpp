@@ -0,0 +1,117 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "PolyphaseFilterbank.hpp"
+
+namespace DFT {
+
+PolyphaseFilterbank::PolyphaseFilterbank(unsigned int N, RealDft::WindowFunction wf, unsigned int taps) : _N(N), _windowFunction(wf), _taps(taps), _realDft(N, RealDft::WindowFunction::Rectangular) {
+    _update(_N, _windowFunction, _taps);
+}
+
+void PolyphaseFilterbank::compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples) {
+    /* Assert sample buffer size */
+    if (samples.size() != _N)
+        throw SizeMismatchException("Samples size does not match DFT size!");
+
+    size_t length = _history.size();
+    size_t latest = length - _N;
+
+    if (_hop > 0 && _hop < _N && memcmp(samples.data(), _history.data() + latest + _hop, sizeof(float) * (_N - _hop)) == 0) {
+        /* Frame continues the history, advance it by the hop */
+        memmove(_history.data(), _history.data() + _hop, sizeof(float) * (length - _hop));
+        memcpy(_history.data() + length - _hop, samples.data() + _N - _hop, sizeof(float) * _hop);
+    } else if (_hop >= _N) {
+        /* Frames do not overlap, advance the history by a frame */
+        memmove(_history.data(), _history.data() + _N, sizeof(float) * latest);
+        memcpy(_history.data() + latest, samples.data(), sizeof(float) * _N);
+    } else {
+        /* Restart the history from the frame */
+        std::fill(_history.begin(), _history.begin() + static_cast<std::ptrdiff_t>(latest), 0.0f);
+        memcpy(_history.data() + latest, samples.data(), sizeof(float) * _N);
+    }
+
+    /* Sum the weighted taps into a single frame, one contiguous pass per tap */
+    std::fill(_filtered.begin(), _filtered.end(), 0.0f);
+    for (unsigned int m = 0; m < _taps; m++) {
+        const float *prototype = _prototype.data() + static_cast<size_t>(m) * _N;
+        const float *history = _history.data() + static_cast<size_t>(m) * _N;
+
+        for (unsigned int n = 0; n < _N; n++)
+            _filtered[n] += prototype[n] * history[n];
+    }
+
+    _realDft.compute(dft, _filtered);
+}
+
+void PolyphaseFilterbank::_update(unsigned int N, RealDft::WindowFunction wf, unsigned int taps) {
+    size_t length = static_cast<size_t>(taps) * N;
+
+    if (_realDft.getSize() != N)
+        _realDft.setSize(N);
+
+    /* Prototype is a sinc with a cutoff of half a bin, windowed over all taps */
+    _prototype.resize(length);
+    calculateWindow(_prototype, wf);
+
+    double center = static_cast<double>(length - 1) / 2.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < length; i++) {
+        double x = (static_cast<double>(i) - center) / static_cast<double>(N);
+        double sinc = (x == 0.0) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+        _prototype[i] = static_cast<float>(static_cast<double>(_prototype[i]) * sinc);
+        sum += static_cast<double>(_prototype[i]);
+    }
+
+    /* Scale DC gain to that of the window over one frame, so levels match the DFT engine */
+    std::vector<float> window(N);
+    calculateWindow(window, wf);
+    double windowSum = 0.0;
+    for (float w : window)
+        windowSum += static_cast<double>(w);
+
+    for (size_t i = 0; i < length; i++)
+        _prototype[i] = static_cast<float>(static_cast<double>(_prototype[i]) * windowSum / sum);
+
+    _history.assign(length, 0.0f);
+    _filtered.resize(N);
+
+    _N = N;
+    _windowFunction = wf;
+    _taps = taps;
+}
+
+unsigned int PolyphaseFilterbank::getSize() {
+    return _N;
+}
+
+void PolyphaseFilterbank::setSize(unsigned int N) {
+    _update(N, _windowFunction, _taps);
+}
+
+RealDft::WindowFunction PolyphaseFilterbank::getWindowFunction() {
+    return _windowFunction;
+}
+
+void PolyphaseFilterbank::setWindowFunction(RealDft::WindowFunction wf) {
+    _update(_N, wf, _taps);
+}
+
+unsigned int PolyphaseFilterbank::getTaps() {
+    return _taps;
+}
+
+void PolyphaseFilterbank::setTaps(unsigned int taps) {
+    _update(_N, _windowFunction, taps);
+}
+
+unsigned int PolyphaseFilterbank::getHop() {
+    return _hop;
+}
+
+void PolyphaseFilterbank::setHop(unsigned int hop) {
+    _hop = hop;
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include "SpectrumEngine.hpp"
+#include "RealDft.hpp"
+
+namespace DFT {
+
+/*
+ * Polyphase filterbank (PFB) channelizer.
+ *
+ * A prototype low-pass filter of M taps per branch, a windowed sinc of M * N
+ * samples with a cutoff of half a bin, weights the last M frames of N samples,
+ * which are summed into a single frame for the N-point DFT. Compared to a
+ * windowed DFT, bins have a flat passband and far less leakage into their
+ * neighbours. The sample history and the prototype are stored tap-major, so
+ * the weighted sum walks both contiguously. The history advances by the hop
+ * between frames, and restarts from the frame when the frame is not the
+ * previous frame advanced by the hop.
+ */
+class PolyphaseFilterbank : public SpectrumEngine {
+  public:
+    PolyphaseFilterbank(unsigned int N, RealDft::WindowFunction wf, unsigned int taps);
+
+    /* Compute PFB spectrum of a frame of samples, advanced by the hop since the last frame */
+    virtual void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples);
+
+    /* Get/Set DFT Size */
+    virtual unsigned int getSize();
+    void setSize(unsigned int N);
+
+    /* Get/Set Window Function of the prototype filter */
+    RealDft::WindowFunction getWindowFunction();
+    void setWindowFunction(RealDft::WindowFunction wf);
+
+    /* Get/Set Taps per branch */
+    unsigned int getTaps();
+    void setTaps(unsigned int taps);
+
+    /* Get/Set Hop between frames in samples */
+    unsigned int getHop();
+    void setHop(unsigned int hop);
+
+  private:
+    void _update(unsigned int N, RealDft::WindowFunction wf, unsigned int taps);
+
+    /* DFT Size */
+    unsigned int _N;
+    /* Window Function */
+    RealDft::WindowFunction _windowFunction;
+    /* Taps per branch */
+    unsigned int _taps;
+    /* Hop between frames */
+    unsigned int _hop = 0;
+
+    /* Unwindowed DFT of the filtered frame */
+    RealDft _realDft;
+
+    /* Prototype filter and sample history, M * N, oldest tap first */
+    std::vector<float> _prototype;
+    std::vector<float> _history;
+    /* Filtered frame */
+    std::vector<float> _filtered;
+};
+
+}
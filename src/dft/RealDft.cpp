@@ -1,4 +1,5 @@
 #include <cmath>
+#include <algorithm>
 
 #include "RealDft.hpp"
 
@@ -17,12 +18,35 @@ std::string to_string(const RealDft::WindowFunction &wf) {
     return "";
 }
 
+std::string to_string(const SpectrumEngine::Type &type) {
+    if (type == SpectrumEngine::Type::Dft)
+        return "DFT";
+    else if (type == SpectrumEngine::Type::ConstantQ)
+        return "Constant-Q";
+    else if (type == SpectrumEngine::Type::SlidingDft)
+        return "Sliding DFT";
+    else if (type == SpectrumEngine::Type::Goertzel)
+        return "Goertzel";
+    else if (type == SpectrumEngine::Type::Multitaper)
+        return "Multitaper";
+    else if (type == SpectrumEngine::Type::Polyphase)
+        return "Polyphase";
+
+    return "";
+}
+
 std::ostream &operator<<(std::ostream &os, const RealDft::WindowFunction &wf) {
     os << to_string(wf);
     return os;
 }
 
-static void calculateWindow(std::vector<float> &window, RealDft::WindowFunction windowFunction) {
+std::mutex PlannerLock;
+
+constexpr unsigned int RealDft::ThreadedSizeMin;
+unsigned int RealDft::_plannerThreads = 1;
+bool RealDft::_plannerThreadsInitialized = false;
+
+void calculateWindow(std::vector<float> &window, RealDft::WindowFunction windowFunction) {
     size_t N = window.size();
     if (windowFunction == RealDft::WindowFunction::Hann) {
         for (unsigned int n = 0; n < N; n++)
@@ -44,14 +68,14 @@ RealDft::RealDft(unsigned int N, RealDft::WindowFunction wf) : _N(N), _windowFun
 }
 
 RealDft::~RealDft() {
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+
     if (_plan)
         fftwf_destroy_plan(_plan);
     if (_dft)
         fftwf_free(_dft);
     if (_windowedSamples)
         fftwf_free(_windowedSamples);
-
-    fftwf_cleanup();
 }
 
 void RealDft::compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples) {
@@ -79,6 +103,8 @@ unsigned int RealDft::getSize() {
 }
 
 void RealDft::setSize(unsigned int N) {
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+
     /* Deallocate FFTW resources we are changing */
     if (_plan)
         fftwf_destroy_plan(_plan);
@@ -102,8 +128,13 @@ void RealDft::setSize(unsigned int N) {
     if (_dft == nullptr)
         throw AllocationException("Allocating DFT memory.");
 
-    /* Rebuild our plan */
+    /* Rebuild our plan, threaded for large sizes, restoring a single thread for other plans */
+    bool threaded = (N >= ThreadedSizeMin && _plannerThreads > 1);
+    if (threaded)
+        fftwf_plan_with_nthreads(static_cast<int>(_plannerThreads));
     _plan = fftwf_plan_dft_r2c_1d(static_cast<int>(N), _windowedSamples, _dft, FFTW_MEASURE);
+    if (threaded)
+        fftwf_plan_with_nthreads(1);
     if (_plan == nullptr)
         throw AllocationException("Creating FFTW plan.");
 
@@ -120,4 +151,22 @@ void RealDft::setWindowFunction(WindowFunction wf) {
     calculateWindow(_window, _windowFunction);
 }
 
+unsigned int RealDft::getPlannerThreads() {
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+    return _plannerThreads;
+}
+
+void RealDft::setPlannerThreads(unsigned int threads) {
+    std::lock_guard<std::mutex> plannerLg(PlannerLock);
+
+    /* Initialize FFTW threads once, on first use */
+    if (threads > 1 && !_plannerThreadsInitialized) {
+        if (fftwf_init_threads() == 0)
+            throw AllocationException("Initializing FFTW threads.");
+        _plannerThreadsInitialized = true;
+    }
+
+    _plannerThreads = std::max(threads, 1u);
+}
+
 }
@@ -3,33 +3,47 @@
 #include <stdexcept>
 #include <vector>
 #include <complex>
+#include <mutex>
 
 #include <fftw3.h>
 
+#include "SpectrumEngine.hpp"
+
 namespace DFT {
 
-class RealDft {
+class RealDft : public SpectrumEngine {
   public:
     enum class WindowFunction { Hann,
                                 Hamming,
                                 Bartlett,
                                 Rectangular };
 
+    /* Smallest DFT size planned with multiple threads */
+    static constexpr unsigned int ThreadedSizeMin = 65536;
+
     RealDft(unsigned int N, WindowFunction wf);
     ~RealDft();
 
     /* Compute new DFT magnitude based on samples */
-    void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples);
+    virtual void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples);
 
     /* Get/Set DFT Size */
-    unsigned int getSize();
+    virtual unsigned int getSize();
     void setSize(unsigned int N);
 
     /* Get/Set Window Function */
     WindowFunction getWindowFunction();
     void setWindowFunction(WindowFunction wf);
 
+    /* Get/Set Threads of plans for sizes of at least ThreadedSizeMin */
+    static unsigned int getPlannerThreads();
+    static void setPlannerThreads(unsigned int threads);
+
   private:
+    /* Planner threads, and whether FFTW threads are initialized */
+    static unsigned int _plannerThreads;
+    static bool _plannerThreadsInitialized;
+
     /* DFT Size */
     unsigned int _N;
     /* Window Function */
@@ -54,6 +68,12 @@ class SizeMismatchException : public std::length_error {
     using std::length_error::length_error;
 };
 
+/* FFTW planner lock, as the planner is not thread-safe */
+extern std::mutex PlannerLock;
+
+/* Calculate window function coefficients over the window size */
+void calculateWindow(std::vector<float> &window, RealDft::WindowFunction windowFunction);
+
 std::ostream &operator<<(std::ostream &os, const RealDft::WindowFunction &wf);
 std::string to_string(const RealDft::WindowFunction &wf);
 
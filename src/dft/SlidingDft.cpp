@@ -0,0 +1,107 @@
+#include <cmath>
+#include <cstring>
+
+#include "SlidingDft.hpp"
+
+namespace DFT {
+
+SlidingDft::SlidingDft(unsigned int N, RealDft::WindowFunction wf) : _N(N), _windowFunction(wf), _realDft(N, RealDft::WindowFunction::Rectangular), _windowedDft(N, wf) {
+    setSize(_N);
+}
+
+void SlidingDft::compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples) {
+    /* Assert sample buffer size */
+    if (samples.size() != _N)
+        throw SizeMismatchException("Samples size does not match DFT size!");
+
+    /* Full DFT for the Bartlett window, which has no short frequency domain kernel */
+    if (_windowFunction == RealDft::WindowFunction::Bartlett) {
+        _windowedDft.compute(dft, samples);
+        _synced = false;
+        return;
+    }
+
+    /* Slide only for hops cheaper than a full DFT, when the frame continues the previous one */
+    bool slide = _synced && _hop > 0 && _hop < static_cast<unsigned int>(std::log2(_N)) && (_slid + _hop) <= _N && memcmp(samples.data(), _samples.data() + _hop, sizeof(float) * (_N - _hop)) == 0;
+
+    if (slide) {
+        size_t bins = _bins.size();
+
+        for (unsigned int n = 0; n < _hop; n++) {
+            float delta = samples[_N - _hop + n] - _samples[n];
+            for (size_t k = 0; k < bins; k++)
+                _bins[k] = (_bins[k] + delta) * _twiddles[k];
+        }
+
+        memcpy(_samples.data(), samples.data(), sizeof(float) * _N);
+        _slid += _hop;
+    } else {
+        _resync(samples);
+    }
+
+    /* Size dft buffer correctly */
+    dft.resize(_N / 2 + 1);
+
+    /* Apply window as a three-tap kernel, using conjugate symmetry at the edges */
+    if (_windowFunction == RealDft::WindowFunction::Rectangular) {
+        dft.assign(_bins.begin(), _bins.end());
+    } else {
+        float a0 = (_windowFunction == RealDft::WindowFunction::Hann) ? 0.5f : 0.54f;
+        float a1 = (1.0f - a0) / 2.0f;
+        size_t last = _N / 2;
+
+        for (size_t k = 0; k <= last; k++) {
+            std::complex<float> below = (k == 0) ? std::conj(_bins[1]) : _bins[k - 1];
+            std::complex<float> above = (k == last) ? std::conj(_bins[last - 1]) : _bins[k + 1];
+            dft[k] = a0 * _bins[k] - a1 * (below + above);
+        }
+    }
+}
+
+void SlidingDft::_resync(const std::vector<float> &samples) {
+    _realDft.compute(_bins, samples);
+    memcpy(_samples.data(), samples.data(), sizeof(float) * _N);
+    _slid = 0;
+    _synced = true;
+}
+
+unsigned int SlidingDft::getSize() {
+    return _N;
+}
+
+void SlidingDft::setSize(unsigned int N) {
+    if (_realDft.getSize() != N)
+        _realDft.setSize(N);
+    if (_windowedDft.getSize() != N)
+        _windowedDft.setSize(N);
+
+    _samples.assign(N, 0.0f);
+    _bins.assign(N / 2 + 1, 0.0f);
+
+    /* Rotation by one sample for each bin */
+    _twiddles.resize(N / 2 + 1);
+    for (unsigned int k = 0; k <= N / 2; k++)
+        _twiddles[k] = std::polar(1.0, 2.0 * M_PI * static_cast<double>(k) / static_cast<double>(N));
+
+    _N = N;
+    _synced = false;
+}
+
+RealDft::WindowFunction SlidingDft::getWindowFunction() {
+    return _windowFunction;
+}
+
+void SlidingDft::setWindowFunction(RealDft::WindowFunction wf) {
+    _windowFunction = wf;
+    _windowedDft.setWindowFunction(wf);
+}
+
+unsigned int SlidingDft::getHop() {
+    return _hop;
+}
+
+void SlidingDft::setHop(unsigned int hop) {
+    _hop = hop;
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include "SpectrumEngine.hpp"
+#include "RealDft.hpp"
+
+namespace DFT {
+
+/*
+ * Sliding DFT for small hops between frames.
+ *
+ * Each new sample updates the unwindowed bins recursively, X_k = (X_k + x_new
+ * - x_old) * e^(j 2 pi k / N), at O(N) per sample instead of O(N log N) per
+ * frame. The Hann and Hamming windows are applied in the frequency domain as
+ * three-tap kernels on the bins (periodic form of the window). The bins are
+ * resynchronized with a full DFT after every N samples slid, to bound drift,
+ * and whenever the frame is not the previous frame advanced by the hop. Hops
+ * too large to benefit, and the Bartlett window, use a full DFT every frame.
+ */
+class SlidingDft : public SpectrumEngine {
+  public:
+    SlidingDft(unsigned int N, RealDft::WindowFunction wf);
+
+    /* Compute DFT of a frame of samples, advanced by the hop since the last frame */
+    virtual void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples);
+
+    /* Get/Set DFT Size */
+    virtual unsigned int getSize();
+    void setSize(unsigned int N);
+
+    /* Get/Set Window Function */
+    RealDft::WindowFunction getWindowFunction();
+    void setWindowFunction(RealDft::WindowFunction wf);
+
+    /* Get/Set Hop between frames in samples */
+    unsigned int getHop();
+    void setHop(unsigned int hop);
+
+  private:
+    void _resync(const std::vector<float> &samples);
+
+    /* DFT Size */
+    unsigned int _N;
+    /* Window Function */
+    RealDft::WindowFunction _windowFunction;
+    /* Hop between frames */
+    unsigned int _hop = 0;
+
+    /* Unwindowed DFT for resynchronization, and windowed DFT for the full DFT fallback */
+    RealDft _realDft;
+    RealDft _windowedDft;
+
+    /* Previous frame, unwindowed bins, and per bin rotation */
+    std::vector<float> _samples;
+    std::vector<std::complex<float>> _bins;
+    std::vector<std::complex<float>> _twiddles;
+
+    /* Samples slid since the last resynchronization, and whether the bins track _samples */
+    size_t _slid = 0;
+    bool _synced = false;
+};
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <complex>
+
+namespace DFT {
+
+class SpectrumEngine {
+  public:
+    enum class Type { Dft,
+                      ConstantQ,
+                      SlidingDft,
+                      Goertzel,
+                      Multitaper,
+                      Polyphase };
+
+    virtual ~SpectrumEngine() {}
+
+    /* Compute spectrum of a frame of samples */
+    virtual void compute(std::vector<std::complex<float>> &dft, const std::vector<float> &samples) = 0;
+
+    /* Get frame size in samples */
+    virtual unsigned int getSize() = 0;
+};
+
+std::string to_string(const SpectrumEngine::Type &type);
+
+}
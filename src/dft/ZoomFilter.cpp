@@ -0,0 +1,102 @@
+#include <cmath>
+#include <algorithm>
+
+#include "ZoomFilter.hpp"
+
+namespace DFT {
+
+constexpr unsigned int ZoomFilter::TapsPerPhase;
+constexpr float ZoomFilter::Passband;
+
+ZoomFilter::ZoomFilter(unsigned int sampleRate, float centerFrequency, unsigned int decimation) : _sampleRate(sampleRate), _centerFrequency(centerFrequency), _decimation(std::max(decimation, 1u)) {
+    setCenterFrequency(_centerFrequency);
+    _designFilter();
+}
+
+void ZoomFilter::_designFilter() {
+    unsigned int N = TapsPerPhase * _decimation;
+    float cutoff = 0.4f / static_cast<float>(_decimation);
+    std::vector<float> h(N);
+    float sum = 0.0f;
+
+    /*
+     * Blackman windowed sinc lowpass at 0.4 of the decimated sample rate. The
+     * transition band spans about 0.34 to 0.48 of the decimated sample rate,
+     * so the stopband (> 70 dB) starts below the decimated Nyquist frequency
+     * and nothing aliases into the passband.
+     */
+    for (unsigned int n = 0; n < N; n++) {
+        float t = static_cast<float>(n) - static_cast<float>(N - 1) / 2.0f;
+        float sinc = (t == 0.0f) ? 1.0f : std::sin(2.0f * static_cast<float>(M_PI) * cutoff * t) / (2.0f * static_cast<float>(M_PI) * cutoff * t);
+        float window = 0.42f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * static_cast<float>(n) / static_cast<float>(N - 1)) + 0.08f * std::cos(4.0f * static_cast<float>(M_PI) * static_cast<float>(n) / static_cast<float>(N - 1));
+        h[n] = sinc * window;
+        sum += h[n];
+    }
+
+    /* Split into polyphase branches, normalized for unity gain at DC */
+    _taps.resize(N);
+    for (unsigned int p = 0; p < _decimation; p++) {
+        for (unsigned int k = 0; k < TapsPerPhase; k++)
+            _taps[p * TapsPerPhase + k] = h[k * _decimation + p] / sum;
+    }
+
+    _delayLines.resize(N);
+    reset();
+}
+
+void ZoomFilter::process(std::vector<std::complex<float>> &output, const std::vector<float> &samples) {
+    for (float sample : samples) {
+        /* Mix down to baseband */
+        std::complex<float> mixed = sample * _phasor;
+        _phasor *= _rotation;
+
+        /* Shift into this branch's delay line */
+        std::complex<float> *line = _delayLines.data() + _phase * TapsPerPhase;
+        std::copy_backward(line, line + TapsPerPhase - 1, line + TapsPerPhase);
+        line[0] = mixed;
+
+        /* Accumulate this branch's contribution to the next output */
+        const float *taps = _taps.data() + _phase * TapsPerPhase;
+        for (unsigned int k = 0; k < TapsPerPhase; k++)
+            _accumulator += taps[k] * line[k];
+
+        /* Emit output once every branch has contributed */
+        if (_phase == 0) {
+            output.push_back(_accumulator);
+            _accumulator = 0.0f;
+            _phase = _decimation - 1;
+        } else {
+            _phase--;
+        }
+    }
+
+    /* Renormalize oscillator to unit magnitude */
+    _phasor /= std::abs(_phasor);
+}
+
+void ZoomFilter::reset() {
+    std::fill(_delayLines.begin(), _delayLines.end(), std::complex<float>(0.0f, 0.0f));
+    _phase = 0;
+    _accumulator = 0.0f;
+    _phasor = 1.0f;
+}
+
+float ZoomFilter::getCenterFrequency() {
+    return _centerFrequency;
+}
+
+void ZoomFilter::setCenterFrequency(float frequency) {
+    _centerFrequency = frequency;
+    _rotation = std::polar(1.0f, -2.0f * static_cast<float>(M_PI) * _centerFrequency / static_cast<float>(_sampleRate));
+}
+
+unsigned int ZoomFilter::getDecimation() {
+    return _decimation;
+}
+
+void ZoomFilter::setDecimation(unsigned int decimation) {
+    _decimation = std::max(decimation, 1u);
+    _designFilter();
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+namespace DFT {
+
+/*
+ * Baseband zoom front-end. Mixes real samples down by a center frequency to
+ * complex baseband, and decimates them with a polyphase lowpass FIR, so that a
+ * narrow band around the center frequency can be resolved by a small complex
+ * DFT at the decimated sample rate.
+ */
+class ZoomFilter {
+  public:
+    ZoomFilter(unsigned int sampleRate, float centerFrequency, unsigned int decimation);
+
+    /* Mix and decimate new samples, appending baseband samples to output */
+    void process(std::vector<std::complex<float>> &output, const std::vector<float> &samples);
+
+    /* Reset filter state */
+    void reset();
+
+    /* Get/Set Center Frequency in Hz */
+    float getCenterFrequency();
+    void setCenterFrequency(float frequency);
+
+    /* Get/Set Decimation */
+    unsigned int getDecimation();
+    void setDecimation(unsigned int decimation);
+
+    /* Passband on either side of the center frequency, as a fraction of the decimated sample rate, flat within 0.1 dB and free of aliasing */
+    static constexpr float Passband = 0.33f;
+
+  private:
+    /* Taps per polyphase branch */
+    static constexpr unsigned int TapsPerPhase = 32;
+
+    void _designFilter();
+
+    const unsigned int _sampleRate;
+    float _centerFrequency;
+    unsigned int _decimation;
+
+    /* Oscillator phasor and per-sample rotation */
+    std::complex<float> _phasor;
+    std::complex<float> _rotation;
+
+    /* Filter taps, by polyphase branch: _taps[p * TapsPerPhase + k] = h[k * D + p] */
+    std::vector<float> _taps;
+    /* Mixed samples per polyphase branch, most recent first */
+    std::vector<std::complex<float>> _delayLines;
+    /* Branch for next input sample */
+    unsigned int _phase;
+    /* Accumulated output of current decimation period */
+    std::complex<float> _accumulator;
+};
+
+}
@@ -1,3 +1,5 @@
+#include <mutex>
+
 #include <Magick++.h>
 
 #include "MagickImageSink.hpp"
@@ -5,7 +7,9 @@
 namespace Image {
 
 MagickImageSink::MagickImageSink(std::string path, unsigned int spectrumWidth, Orientation orientation) : _path(path), _spectrumWidth(spectrumWidth), _orientation(orientation) {
-    Magick::InitializeMagick(nullptr);
+    /* Initialize GraphicsMagick once, as image sinks may be created from worker threads */
+    static std::once_flag initializeFlag;
+    std::call_once(initializeFlag, []() { Magick::InitializeMagick(nullptr); });
 }
 
 void MagickImageSink::append(const std::vector<uint32_t> &pixels) {
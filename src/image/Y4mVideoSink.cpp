@@ -0,0 +1,94 @@
+#include <cstring>
+#include <iostream>
+
+#include "Y4mVideoSink.hpp"
+
+namespace Image {
+
+/* BT.601 limited range black */
+static const uint8_t BlackY = 16;
+static const uint8_t BlackC = 128;
+
+Y4mVideoSink::Y4mVideoSink(std::string path, unsigned int spectrumWidth, unsigned int timeWidth, Orientation orientation, unsigned int fps, unsigned int sampleRate, unsigned int samplesHop) : _spectrumWidth(spectrumWidth), _timeWidth(timeWidth), _orientation(orientation), _fps(fps), _sampleRate(sampleRate), _samplesHop(samplesHop), _frame(3 * static_cast<size_t>(spectrumWidth) * timeWidth) {
+    if (path == "-") {
+        _stream = &std::cout;
+    } else {
+        _file.open(path, std::ios::binary | std::ios::trunc);
+        if (!_file)
+            throw VideoWriteException("Error opening video file: " + path);
+        _stream = &_file;
+    }
+
+    /* Rows are laid out by slot in vertical orientation, and by line in horizontal orientation, so frames are assembled by copying */
+    size_t planeSize = static_cast<size_t>(_spectrumWidth) * _timeWidth;
+    _ring.resize(3 * planeSize);
+    memset(_ring.data(), BlackY, planeSize);
+    memset(_ring.data() + planeSize, BlackC, 2 * planeSize);
+
+    unsigned int width = (_orientation == Orientation::Vertical) ? _spectrumWidth : _timeWidth;
+    unsigned int height = (_orientation == Orientation::Vertical) ? _timeWidth : _spectrumWidth;
+
+    *_stream << "YUV4MPEG2 W" << width << " H" << height << " F" << _fps << ":1 Ip A1:1 C444\n";
+    if (!*_stream)
+        throw VideoWriteException("Error writing video header.");
+}
+
+void Y4mVideoSink::append(const std::vector<uint32_t> &pixels) {
+    if (pixels.size() != _spectrumWidth)
+        throw VideoWriteException("Pixels size does not match video spectrum width!");
+
+    size_t planeSize = static_cast<size_t>(_spectrumWidth) * _timeWidth;
+    uint8_t *y = _ring.data();
+    uint8_t *cb = y + planeSize;
+    uint8_t *cr = cb + planeSize;
+
+    /* Convert row to YCbCr into the ring slot, at a column of each line in horizontal orientation, low frequencies at the bottom */
+    size_t offset = (_orientation == Orientation::Vertical) ? (_head * _spectrumWidth) : ((_spectrumWidth - 1) * static_cast<size_t>(_timeWidth) + _head);
+    std::ptrdiff_t stride = (_orientation == Orientation::Vertical) ? 1 : -static_cast<std::ptrdiff_t>(_timeWidth);
+
+    for (size_t i = 0; i < _spectrumWidth; i++) {
+        int r = static_cast<int>((pixels[i] >> 16) & 0xff);
+        int g = static_cast<int>((pixels[i] >> 8) & 0xff);
+        int b = static_cast<int>(pixels[i] & 0xff);
+
+        size_t index = static_cast<size_t>(static_cast<std::ptrdiff_t>(offset) + stride * static_cast<std::ptrdiff_t>(i));
+        y[index] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        cb[index] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        cr[index] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    _head = (_head + 1) % _timeWidth;
+    _rows++;
+
+    /* Emit frames whose time the rows have reached */
+    while (_frames * _sampleRate <= _rows * _samplesHop * _fps)
+        _writeFrame();
+}
+
+void Y4mVideoSink::_writeFrame() {
+    size_t planeSize = static_cast<size_t>(_spectrumWidth) * _timeWidth;
+
+    /* Copy the ring from the oldest row at _head, a plane at a time in vertical orientation, a line at a time in horizontal orientation */
+    size_t lineSize = (_orientation == Orientation::Vertical) ? planeSize : _timeWidth;
+    size_t split = (_orientation == Orientation::Vertical) ? (_head * _spectrumWidth) : _head;
+
+    for (size_t line = 0; line < _frame.size(); line += lineSize) {
+        memcpy(_frame.data() + line, _ring.data() + line + split, lineSize - split);
+        memcpy(_frame.data() + line + (lineSize - split), _ring.data() + line, split);
+    }
+
+    *_stream << "FRAME\n";
+    _stream->write(reinterpret_cast<const char *>(_frame.data()), static_cast<std::streamsize>(_frame.size()));
+    if (!*_stream)
+        throw VideoWriteException("Error writing video frame.");
+
+    _frames++;
+}
+
+void Y4mVideoSink::write() {
+    _stream->flush();
+    if (!*_stream)
+        throw VideoWriteException("Error finalizing video.");
+}
+
+}
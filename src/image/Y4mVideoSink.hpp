@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+#include "ImageSink.hpp"
+
+namespace Image {
+
+/*
+ * Scrolling spectrogram video as a YUV4MPEG2 (Y4M) stream of 4:4:4 frames,
+ * for an external encoder.
+ *
+ * Appended pixel rows are converted to BT.601 YCbCr once, into a ring of the
+ * last time width rows. Frames are emitted as the rows reach each frame time,
+ * repeating or skipping rows as needed to keep the frame rate, and each frame
+ * is assembled from the ring with the newest row at the bottom (vertical) or
+ * at the right (horizontal), as in the real-time interface.
+ */
+class Y4mVideoSink : public ImageSink {
+  public:
+    enum class Orientation { Horizontal,
+                             Vertical };
+
+    Y4mVideoSink(std::string path, unsigned int spectrumWidth, unsigned int timeWidth, Orientation orientation, unsigned int fps, unsigned int sampleRate, unsigned int samplesHop);
+
+    virtual void append(const std::vector<uint32_t> &pixels);
+    virtual void write();
+
+  private:
+    void _writeFrame();
+
+    const unsigned int _spectrumWidth, _timeWidth;
+    const Orientation _orientation;
+    const unsigned int _fps, _sampleRate, _samplesHop;
+
+    /* Output file, or standard output */
+    std::ofstream _file;
+    std::ostream *_stream;
+
+    /* Ring of converted rows, planar Y, Cb, Cr, spectrum width by time width, next row at _head */
+    std::vector<uint8_t> _ring;
+    size_t _head = 0;
+    uint64_t _rows = 0;
+
+    /* Frames emitted, and assembled frame */
+    uint64_t _frames = 0;
+    std::vector<uint8_t> _frame;
+};
+
+class VideoWriteException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+}
@@ -1,8 +1,15 @@
 #include "AudioThread.hpp"
+#include "audio/PulseAudioSource.hpp"
+#include "audio/RawAudioSource.hpp"
 
 #define AUDIO_READ_SIZE 128
 
-AudioThread::AudioThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, const Configuration::Settings &initialSettings) : _samplesQueue(samplesQueue), _audioSource(initialSettings.audioSampleRate) {}
+AudioThread::AudioThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, const Configuration::Settings &initialSettings, std::string device) : _samplesQueue(samplesQueue), _sampleRate(initialSettings.audioSampleRate) {
+    if (initialSettings.audioRaw)
+        _audioSource.reset(new Audio::RawAudioSource(initialSettings.audioPath, initialSettings.audioRawFormat, initialSettings.audioSampleRate, initialSettings.audioChannels));
+    else
+        _audioSource.reset(new Audio::PulseAudioSource(initialSettings.audioSampleRate, device));
+}
 
 void AudioThread::start() {
     _running = true;
@@ -10,7 +17,12 @@ void AudioThread::start() {
 }
 
 void AudioThread::stop() {
+    /* Stopped already, or never started */
+    if (!_thread.joinable())
+        return;
+
     _running = false;
+    _audioSource->cancel();
     _thread.join();
 }
 
@@ -18,16 +30,17 @@ void AudioThread::_run() {
     std::vector<float> samples(AUDIO_READ_SIZE);
 
     while (_running) {
-        {
-            std::lock_guard<std::mutex> lg(_audioSourceLock);
-            _audioSource.read(samples);
-        }
+        samples.resize(AUDIO_READ_SIZE);
+        _audioSource->read(samples);
+
+        /* End of stream */
+        if (samples.empty())
+            break;
 
         _samplesQueue.push(samples);
     }
 }
 
 unsigned int AudioThread::getSampleRate() {
-    std::lock_guard<std::mutex> lg(_audioSourceLock);
-    return _audioSource.getSampleRate();
+    return _sampleRate;
 }
@@ -3,14 +3,15 @@
 #include <vector>
 #include <atomic>
 #include <thread>
+#include <memory>
 
 #include "ThreadSafeQueue.hpp"
-#include "audio/PulseAudioSource.hpp"
+#include "audio/AudioSource.hpp"
 #include "Configuration.hpp"
 
 class AudioThread {
   public:
-    AudioThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, const Configuration::Settings &initialSettings);
+    AudioThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, const Configuration::Settings &initialSettings, std::string device = "");
 
     void start();
     void stop();
@@ -24,8 +25,9 @@ class AudioThread {
     /* Output samples queue */
     ThreadSafeQueue<std::vector<float>> &_samplesQueue;
 
-    Audio::PulseAudioSource _audioSource;
-    std::mutex _audioSourceLock;
+    /* PulseAudio or raw PCM source, owned by the audio thread */
+    std::unique_ptr<Audio::AudioSource> _audioSource;
+    const unsigned int _sampleRate;
 
     std::atomic<bool> _running;
     std::thread _thread;
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "audio/AudioSource.hpp"
+#include "audio/RawAudioSource.hpp"
 #include "dft/RealDft.hpp"
 #include "spectrogram/SpectrumRenderer.hpp"
+#include "spectrogram/FrequencyAxis.hpp"
+#include "spectrogram/SpectrumAverager.hpp"
+#include "cache/NpyMagnitudeWriter.hpp"
 
 using namespace DFT;
 using namespace Spectrogram;
@@ -12,23 +19,71 @@ namespace Configuration {
 enum class Orientation { Horizontal,
                          Vertical };
 
+struct AudioSourceSettings {
+    /* PulseAudio source device name */
+    std::string device;
+    /* Sample rate, or 0 for the audio sample rate setting */
+    unsigned int sampleRate;
+};
+
 struct Settings {
     /* Interface Settings */
     bool fullscreen = false;
     unsigned int width = 640;
     unsigned int height = 480;
     Orientation orientation = Orientation::Vertical;
+    unsigned int historyDuration = 1800;
     /* Audio Settings */
     unsigned int audioSampleRate = 24000;
+    std::vector<AudioSourceSettings> audioSources;
+    /* Raw PCM input path ("-" for standard input), format, and channels */
+    bool audioRaw = false;
+    std::string audioPath;
+    Audio::RawAudioSource::Format audioRawFormat = Audio::RawAudioSource::Format::S16;
+    unsigned int audioChannels = 1;
+    /* Time range to render in WAV file mode, in seconds, 0 duration for the rest */
+    float audioStart = 0.0f;
+    float audioDuration = 0.0f;
+    /* Spectrum format of NPY output in WAV file mode */
+    Cache::NpyMagnitudeWriter::Format npyFormat = Cache::NpyMagnitudeWriter::Format::Power;
+    /* Frame rate of video output in WAV file mode */
+    unsigned int videoFps = 30;
     /* DFT Settings */
     float samplesOverlap = 0.50;
     unsigned int dftSize = 1024;
     RealDft::WindowFunction dftWindowFunction = RealDft::WindowFunction::Hann;
+    SpectrumEngine::Type dftEngine = SpectrumEngine::Type::Dft;
+    /* Real-time DFT worker threads, or 0 for one per core */
+    unsigned int dftThreads = 0;
+    /* FFTW threads for large DFT sizes, or 0 for one per core */
+    unsigned int fftThreads = 0;
+    /* Polyphase Filterbank Settings */
+    unsigned int pfbTaps = 4;
+    /* Constant-Q Settings */
+    unsigned int cqtBinsPerOctave = 24;
+    float cqtMinFrequency = 32.7f;
+    /* Multitaper Settings */
+    unsigned int multitaperTapers = 7;
+    /* Goertzel Settings */
+    std::vector<float> goertzelFrequencies;
+    /* Averaging Settings */
+    SpectrumAverager::Mode averageMode = SpectrumAverager::Mode::None;
+    float averageAlpha = 0.25f;
+    unsigned int averageFrames = 8;
+    /* Zoom Settings */
+    float zoomFrequency = 0.0;
+    unsigned int zoomDecimation = 1;
+    /* Shared memory frame ring name, or empty for none, slots, and replacing an existing ring */
+    std::string frameRingName;
+    unsigned int frameRingSlots = 256;
+    bool frameRingReplace = false;
     /* Spectrogram Settings */
     float magnitudeMin = 0.0;
     float magnitudeMax = 45.0;
     bool magnitudeLog = true;
+    bool magnitudeAuto = false;
     SpectrumRenderer::ColorScheme colorScheme = SpectrumRenderer::ColorScheme::Heat;
+    FrequencyAxis::Scale frequencyScale = FrequencyAxis::Scale::Linear;
     /* Initial settings when switching between logarithmic/linear in UI */
     float magnitudeLogMin = 0.0;
     float magnitudeLogMax = 50.0;
@@ -48,6 +103,34 @@ struct Limits {
     /* DFT size min, max */
     unsigned int dftSizeMin = 64;
     unsigned int dftSizeMax = 8192;
+    /* DFT size max in WAV file mode */
+    unsigned int dftSizeOfflineMax = 1048576;
+    /* Real-time DFT worker threads and FFTW threads max */
+    unsigned int dftThreadsMax = 64;
+    /* Raw PCM input channels max */
+    unsigned int audioChannelsMax = 64;
+    /* Video output frame rate max */
+    unsigned int videoFpsMax = 240;
+    /* Batch mode concurrent files max */
+    unsigned int batchJobsMax = 64;
+    /* Polyphase filterbank taps min, max */
+    unsigned int pfbTapsMin = 2;
+    unsigned int pfbTapsMax = 16;
+    /* Constant-Q bins per octave min, max */
+    unsigned int cqtBinsPerOctaveMin = 12;
+    unsigned int cqtBinsPerOctaveMax = 48;
+    /* Multitaper tapers min, max */
+    unsigned int multitaperTapersMin = 2;
+    unsigned int multitaperTapersMax = 15;
+    /* Boxcar averaging frames max */
+    unsigned int averageFramesMax = 64;
+    /* Zoom decimation max */
+    unsigned int zoomDecimationMax = 64;
+    /* Shared memory frame ring slots min, max */
+    unsigned int frameRingSlotsMin = 2;
+    unsigned int frameRingSlotsMax = 4096;
+    /* Scrollback history rows max, bounding memory at small hops */
+    size_t historyRowsMax = 262144;
     /* Samples overlap min, max, step */
     float samplesOverlapMin = 0.05f;
     float samplesOverlapMax = 0.95f;
@@ -0,0 +1,119 @@
+#include <ftw.h>
+#include <fnmatch.h>
+#include <cstdarg>
+#include <map>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "InterfaceHelpers.hpp"
+
+static const std::string FontDirectory = "/usr/share/fonts";
+
+static const std::vector<std::string> FontFilesSearch = {
+    "DejaVuSansMono-Bold.ttf",
+    "VeraMoBd.ttf",
+    "UbuntuMono-R.ttf",
+    "LiberationMono-Regular.ttf",
+    "FreeMono.ttf",
+};
+
+static std::map<std::string, std::string> FontFilesAvailable;
+
+static int fontCrawlCallback(const char *fpath, const struct stat *sb, int typeflag) {
+    (void)sb;
+
+    if (typeflag == FTW_F) {
+        std::string path = std::string(fpath);
+
+        /* Find the last slash */
+        auto slashpos = path.rfind("/");
+
+        if (slashpos != std::string::npos) {
+            /* Extract filename */
+            std::string filename = path.substr(slashpos + 1);
+
+            /* If it's a TTF file, add it to our available font files map */
+            if (fnmatch("*.ttf", filename.c_str(), FNM_CASEFOLD) == 0)
+                FontFilesAvailable[filename] = path;
+        }
+    }
+
+    return 0;
+}
+
+std::string findFontPath() {
+    /* Crawl font directory to build a map of all TTF fonts */
+    if (ftw(FontDirectory.c_str(), fontCrawlCallback, 5) < 0)
+        throw std::runtime_error("Unable to crawl font directory " + FontDirectory);
+
+    /* Look for any matches with our desired font files */
+    for (const auto &fontFile : FontFilesSearch) {
+        if (FontFilesAvailable.find(fontFile) != FontFilesAvailable.end())
+            return FontFilesAvailable[fontFile];
+    }
+
+    return "";
+}
+
+std::string format(const char *fmt, ...) {
+    char buf[64];
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return std::string(buf);
+}
+
+SDL_Surface *renderString(std::string s, TTF_Font *font, const SDL_Color &color) {
+    SDL_Surface *surface;
+
+    surface = TTF_RenderText_Solid(font, s.c_str(), color);
+    if (surface == nullptr)
+        throw TTFException("Error rendering text: TTF_RenderText_Solid(): " + std::string(TTF_GetError()));
+
+    return surface;
+}
+
+SDL_Surface *vcatSurfaces(std::vector<SDL_Surface *> surfaces, Alignment aligned) {
+    SDL_Surface *targetSurface = nullptr;
+    int targetSurfaceWidth = 0, targetSurfaceHeight = 0;
+
+    /* Compute size of target surface */
+    for (SDL_Surface *surface : surfaces) {
+        if (surface->w > targetSurfaceWidth)
+            targetSurfaceWidth = surface->w;
+        targetSurfaceHeight += surface->h;
+    }
+
+    /* Create target surface */
+    targetSurface = SDL_CreateRGBSurface(0, targetSurfaceWidth, targetSurfaceHeight, 32, SDL_R_MASK, SDL_G_MASK, SDL_B_MASK, SDL_A_MASK);
+    if (targetSurface == nullptr)
+        throw SDLException("Error creating target surface: SDL_CreateRGBSurface(): " + std::string(SDL_GetError()));
+
+    /* Blit each text surface onto the target surface */
+    int offset = 0;
+    for (SDL_Surface *surface : surfaces) {
+        SDL_Rect targetRect;
+
+        if (aligned == Alignment::Left)
+            targetRect.x = 0;
+        else if (aligned == Alignment::Center)
+            targetRect.x = (targetSurfaceWidth - surface->w) / 2;
+        else if (aligned == Alignment::Right)
+            targetRect.x = targetSurfaceWidth - surface->w;
+
+        targetRect.y = offset;
+        targetRect.w = surface->w;
+        targetRect.h = surface->h;
+
+        offset += surface->h;
+
+        if (SDL_BlitSurface(surface, nullptr, targetSurface, &targetRect) < 0)
+            throw SDLException("Error blitting text surfaces: SDL_BlitSurface(): " + std::string(SDL_GetError()));
+
+        SDL_FreeSurface(surface);
+    }
+
+    return targetSurface;
+}
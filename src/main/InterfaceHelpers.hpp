@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+#define SDL_R_MASK (0xffu << 24)
+#define SDL_G_MASK (0xffu << 16)
+#define SDL_B_MASK (0xffu << 8)
+#define SDL_A_MASK (0xffu)
+#else
+#define SDL_R_MASK (0xffu)
+#define SDL_G_MASK (0xffu << 8)
+#define SDL_B_MASK (0xffu << 16)
+#define SDL_A_MASK (0xffu << 24)
+#endif
+
+/* Find path of a compatible TTF font */
+std::string findFontPath();
+
+/* Format a string printf-style */
+std::string format(const char *fmt, ...);
+
+/* Render a string to a new surface */
+SDL_Surface *renderString(std::string s, TTF_Font *font, const SDL_Color &color);
+
+enum class Alignment { Left,
+                       Center,
+                       Right };
+
+/* Vertically concatenate surfaces into a new surface, freeing them */
+SDL_Surface *vcatSurfaces(std::vector<SDL_Surface *> surfaces, Alignment aligned);
+
+class SDLException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+class TTFException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
@@ -1,79 +1,19 @@
-#include <ftw.h>
-#include <fnmatch.h>
-#include <map>
-
 #include <SDL.h>
 #include <SDL_ttf.h>
 
 #include "InterfaceThread.hpp"
 #include "Configuration.hpp"
 
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-#define SDL_R_MASK (0xffu << 24)
-#define SDL_G_MASK (0xffu << 16)
-#define SDL_B_MASK (0xffu << 8)
-#define SDL_A_MASK (0xffu)
-#else
-#define SDL_R_MASK (0xffu)
-#define SDL_G_MASK (0xffu << 8)
-#define SDL_B_MASK (0xffu << 16)
-#define SDL_A_MASK (0xffu << 24)
-#endif
-
 using namespace Audio;
 using namespace DFT;
 using namespace Spectrogram;
 using namespace Configuration;
 
-static const std::string FontDirectory = "/usr/share/fonts";
-
-static const std::vector<std::string> FontFilesSearch = {
-    "DejaVuSansMono-Bold.ttf",
-    "VeraMoBd.ttf",
-    "UbuntuMono-R.ttf",
-    "LiberationMono-Regular.ttf",
-    "FreeMono.ttf",
-};
-
-static std::map<std::string, std::string> FontFilesAvailable;
-
-static int fontCrawlCallback(const char *fpath, const struct stat *sb, int typeflag) {
-    (void)sb;
-
-    if (typeflag == FTW_F) {
-        std::string path = std::string(fpath);
-
-        /* Find the last slash */
-        auto slashpos = path.rfind("/");
-
-        if (slashpos != std::string::npos) {
-            /* Extract filename */
-            std::string filename = path.substr(slashpos + 1);
-
-            /* If it's a TTF file, add it to our available font files map */
-            if (fnmatch("*.ttf", filename.c_str(), FNM_CASEFOLD) == 0)
-                FontFilesAvailable[filename] = path;
-        }
-    }
-
-    return 0;
-}
-
-static std::string findFontPath() {
-    /* Crawl font directory to build a map of all TTF fonts */
-    if (ftw(FontDirectory.c_str(), fontCrawlCallback, 5) < 0)
-        throw std::runtime_error("Unable to crawl font directory " + FontDirectory);
-
-    /* Look for any matches with our desired font files */
-    for (const auto &fontFile : FontFilesSearch) {
-        if (FontFilesAvailable.find(fontFile) != FontFilesAvailable.end())
-            return FontFilesAvailable[fontFile];
-    }
-
-    return "";
-}
+constexpr unsigned int InterfaceThread::AutoRangeInterval;
+constexpr float InterfaceThread::AutoRangeDecay;
+constexpr float InterfaceThread::AutoRangeEasing;
 
-InterfaceThread::InterfaceThread(ThreadSafeQueue<std::vector<uint32_t>> &pixelsQueue, AudioThread &audioThread, SpectrogramThread &spectrogramThread, const Settings &initialSettings) : _pixelsQueue(pixelsQueue), _audioThread(audioThread), _spectrogramThread(spectrogramThread), _fullscreen(initialSettings.fullscreen), _width(initialSettings.width), _height(initialSettings.height), _orientation(initialSettings.orientation) {
+InterfaceThread::InterfaceThread(ThreadSafeQueue<std::vector<uint16_t>> &magnitudesQueue, AudioThread &audioThread, SpectrogramThread &spectrogramThread, const Settings &initialSettings) : _magnitudesQueue(magnitudesQueue), _audioThread(audioThread), _spectrogramThread(spectrogramThread), _spectrumRenderer(initialSettings.magnitudeMin, initialSettings.magnitudeMax, initialSettings.magnitudeLog, initialSettings.colorScheme), _magnitudeHistory(0, 0), _historyDuration(initialSettings.historyDuration), _resizeSource(0, 0), _resizeResult(0, 0), _resizeCancel(false), _resizeDone(false), _fullscreen(initialSettings.fullscreen), _width(initialSettings.width), _height(initialSettings.height), _orientation(initialSettings.orientation), _magnitudeAuto(initialSettings.magnitudeAuto) {
     int ret;
 
     /* Initialize SDL */
@@ -109,6 +49,14 @@ InterfaceThread::InterfaceThread(ThreadSafeQueue<std::vector<uint32_t>> &pixelsQ
     if (_renderer == nullptr)
         throw SDLException("Creating SDL renderer: SDL_CreateRenderer(): " + std::string(SDL_GetError()));
 
+    /* Size magnitude history to history duration at initial DFT size and overlap */
+    float rowRate = static_cast<float>(initialSettings.audioSampleRate) / (static_cast<float>(initialSettings.dftSize) * (1.0f - initialSettings.samplesOverlap) * static_cast<float>(initialSettings.zoomDecimation));
+    _historyRows = std::min(static_cast<size_t>(rowRate * static_cast<float>(initialSettings.historyDuration)), UserLimits.historyRowsMax);
+
+    /* Allocate magnitude history and pixel buffer */
+    _magnitudeHistory.resize(std::max(_historyRows, static_cast<size_t>(getTimeWidth())), getSpectrumWidth());
+    _pixels.resize(_width * _height);
+
     /* Create main texture */
     _pixelsTexture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STATIC, static_cast<int>(getSpectrumWidth()), static_cast<int>(getTimeWidth()));
     if (_pixelsTexture == nullptr)
@@ -126,6 +74,12 @@ InterfaceThread::InterfaceThread(ThreadSafeQueue<std::vector<uint32_t>> &pixelsQ
 }
 
 InterfaceThread::~InterfaceThread() {
+    /* Stop history resampling */
+    if (_resizing) {
+        _resizeCancel = true;
+        _resizeThread.join();
+    }
+
     TTF_CloseFont(_font);
     if (_pixelsTexture)
         SDL_DestroyTexture(_pixelsTexture);
@@ -137,6 +91,8 @@ InterfaceThread::~InterfaceThread() {
         SDL_DestroyTexture(_statisticsTexture);
     if (_helpTexture)
         SDL_DestroyTexture(_helpTexture);
+    if (_levelsTexture)
+        SDL_DestroyTexture(_levelsTexture);
 
     SDL_DestroyRenderer(_renderer);
     SDL_DestroyWindow(_win);
@@ -144,81 +100,164 @@ InterfaceThread::~InterfaceThread() {
     SDL_Quit();
 }
 
-static std::string format(const char *fmt, ...) {
-    char buf[64];
-    va_list ap;
-    va_start(ap, fmt);
-    std::vsnprintf(buf, sizeof(buf), fmt, ap);
-    va_end(ap);
-    return std::string(buf);
+void InterfaceThread::_updateSettings() {
+    _settings.audioSampleRate = _audioThread.getSampleRate();
+    _settings.samplesOverlap = _spectrogramThread.getSamplesOverlap();
+    _settings.dftSize = _spectrogramThread.getDftSize();
+    _settings.dftWindowFunction = _spectrogramThread.getDftWindowFunction();
+    _settings.dftEngine = _spectrogramThread.getEngine();
+    _settings.cqtBinsPerOctave = _spectrogramThread.getCqtBinsPerOctave();
+    _settings.cqtMinFrequency = _spectrogramThread.getCqtMinFrequency();
+    _settings.multitaperTapers = _spectrogramThread.getMultitaperTapers();
+    _settings.pfbTaps = _spectrogramThread.getPfbTaps();
+    _settings.averageMode = _spectrogramThread.getAverageMode();
+    _settings.zoomFrequency = _spectrogramThread.getZoomFrequency();
+    _settings.zoomDecimation = _spectrogramThread.getZoomDecimation();
+    _settings.frequencyScale = _spectrogramThread.getFrequencyScale();
+    _settings.magnitudeMin = _spectrumRenderer.getMagnitudeMin();
+    _settings.magnitudeMax = _spectrumRenderer.getMagnitudeMax();
+    _settings.magnitudeLog = _spectrumRenderer.getMagnitudeLog();
+    _settings.colorScheme = _spectrumRenderer.getColorScheme();
 }
 
-static SDL_Surface *renderString(std::string s, TTF_Font *font, const SDL_Color &color) {
-    SDL_Surface *surface;
+void InterfaceThread::_renderPixels() {
+    size_t timeWidth = getTimeWidth(), spectrumWidth = getSpectrumWidth();
+    size_t count = _getHistoryCount();
 
-    surface = TTF_RenderText_Solid(font, s.c_str(), color);
-    if (surface == nullptr)
-        throw TTFException("Error rendering text: TTF_RenderText_Solid(): " + std::string(TTF_GetError()));
+    /* Recolor all visible rows with current spectrum renderer settings */
+    for (size_t i = 0; i < timeWidth; i++) {
+        /* Rows before the start of history are blank */
+        if (count < _historyOffset + timeWidth - i)
+            std::fill(_pixels.data() + i * spectrumWidth, _pixels.data() + (i + 1) * spectrumWidth, 0);
+        else
+            _spectrumRenderer.render(_pixels.data() + i * spectrumWidth, _getHistoryRow(count - _historyOffset - timeWidth + i), spectrumWidth);
+    }
 
-    return surface;
+    SDL_UpdateTexture(_pixelsTexture, nullptr, _pixels.data(), static_cast<int>(spectrumWidth * sizeof(uint32_t)));
 }
 
-enum class Alignment { Left,
-                       Center,
-                       Right };
+void InterfaceThread::_scrollHistory(long rows) {
+    size_t count = _getHistoryCount();
+    size_t maxOffset = (count > getTimeWidth()) ? count - getTimeWidth() : 0;
 
-static SDL_Surface *vcatSurfaces(std::vector<SDL_Surface *> surfaces, Alignment aligned) {
-    SDL_Surface *targetSurface = nullptr;
-    int targetSurfaceWidth = 0, targetSurfaceHeight = 0;
+    /* Scroll back (positive) or forward (negative), clamped to history */
+    if (rows < 0)
+        _historyOffset -= std::min(_historyOffset, static_cast<size_t>(-rows));
+    else
+        _historyOffset = std::min(_historyOffset + static_cast<size_t>(rows), maxOffset);
 
-    /* Compute size of target surface */
-    for (SDL_Surface *surface : surfaces) {
-        if (surface->w > targetSurfaceWidth)
-            targetSurfaceWidth = surface->w;
-        targetSurfaceHeight += surface->h;
-    }
+    /* Scrolling pauses the display */
+    _paused = true;
 
-    /* Create target surface */
-    targetSurface = SDL_CreateRGBSurface(0, targetSurfaceWidth, targetSurfaceHeight, 32, SDL_R_MASK, SDL_G_MASK, SDL_B_MASK, SDL_A_MASK);
-    if (targetSurface == nullptr)
-        throw SDLException("Error creating target surface: SDL_CreateRGBSurface(): " + std::string(SDL_GetError()));
+    _renderPixels();
+}
 
-    /* Blit each text surface onto the target surface */
-    int offset = 0;
-    for (SDL_Surface *surface : surfaces) {
-        SDL_Rect targetRect;
+size_t InterfaceThread::_getHistoryCount() {
+    /* While resizing, older rows are still in the resize source */
+    return _magnitudeHistory.getCount() + (_resizing ? _resizeSource.getCount() : 0);
+}
 
-        if (aligned == Alignment::Left)
-            targetRect.x = 0;
-        else if (aligned == Alignment::Center)
-            targetRect.x = (targetSurfaceWidth - surface->w) / 2;
-        else if (aligned == Alignment::Right)
-            targetRect.x = targetSurfaceWidth - surface->w;
+double InterfaceThread::_getHistoryTime(size_t index) {
+    if (!_resizing)
+        return _magnitudeHistory.time(index);
 
-        targetRect.y = offset;
-        targetRect.w = surface->w;
-        targetRect.h = surface->h;
+    if (index >= _resizeSource.getCount())
+        return _magnitudeHistory.time(index - _resizeSource.getCount());
 
-        offset += surface->h;
+    return _resizeSource.time(index);
+}
 
-        if (SDL_BlitSurface(surface, nullptr, targetSurface, &targetRect) < 0)
-            throw SDLException("Error blitting text surfaces: SDL_BlitSurface(): " + std::string(SDL_GetError()));
+double InterfaceThread::_getRowDuration() {
+    return static_cast<double>(_getHop()) * static_cast<double>(_settings.zoomDecimation) / static_cast<double>(_settings.audioSampleRate);
+}
 
-        SDL_FreeSurface(surface);
+void InterfaceThread::_updateHistoryRows() {
+    /* Resize history to the history duration at the current row duration, keeping the newest rows */
+    size_t rows = std::min(static_cast<size_t>(static_cast<double>(_historyDuration) / _getRowDuration()), UserLimits.historyRowsMax);
+    if (rows == _historyRows)
+        return;
+
+    size_t oldRows = std::max(_historyRows, static_cast<size_t>(getTimeWidth()));
+    _historyRows = rows;
+
+    if (std::max(_historyRows, static_cast<size_t>(getTimeWidth())) != oldRows)
+        _startResize();
+}
+
+const uint16_t *InterfaceThread::_getHistoryRow(size_t index) {
+    if (!_resizing)
+        return _magnitudeHistory.row(index);
+
+    if (index >= _resizeSource.getCount())
+        return _magnitudeHistory.row(index - _resizeSource.getCount());
+
+    /* Resample row from resize source on the fly */
+    _resizeRow.resize(getSpectrumWidth());
+    SpectrumRenderer::resample(_resizeRow, _resizeSource.row(index), _resizeSource.getWidth());
+
+    return _resizeRow.data();
+}
+
+void InterfaceThread::_startResize() {
+    size_t rows = std::max(_historyRows, static_cast<size_t>(getTimeWidth()));
+
+    if (_resizing) {
+        /* Cancel resampling in progress */
+        _resizeCancel = true;
+        _resizeThread.join();
+
+        /* Fold rows received since into the resize source */
+        std::vector<uint16_t> row(_resizeSource.getWidth());
+        for (size_t i = 0; i < _magnitudeHistory.getCount(); i++) {
+            SpectrumRenderer::resample(row, _magnitudeHistory.row(i), _magnitudeHistory.getWidth());
+            _resizeSource.push(row, _magnitudeHistory.time(i));
+        }
+    } else {
+        std::swap(_resizeSource, _magnitudeHistory);
     }
 
-    return targetSurface;
+    /* Collect new rows at the new width while resampling */
+    _magnitudeHistory.resize(rows, getSpectrumWidth());
+
+    _resizeCancel = false;
+    _resizeDone = false;
+    _resizing = true;
+    _resizeThread = std::thread(&InterfaceThread::_resampleHistory, this, rows, static_cast<size_t>(getSpectrumWidth()));
 }
 
-void InterfaceThread::_updateSettings() {
-    _settings.audioSampleRate = _audioThread.getSampleRate();
-    _settings.samplesOverlap = _spectrogramThread.getSamplesOverlap();
-    _settings.dftSize = _spectrogramThread.getDftSize();
-    _settings.dftWindowFunction = _spectrogramThread.getDftWindowFunction();
-    _settings.magnitudeMin = _spectrogramThread.getMagnitudeMin();
-    _settings.magnitudeMax = _spectrogramThread.getMagnitudeMax();
-    _settings.magnitudeLog = _spectrogramThread.getMagnitudeLog();
-    _settings.colorScheme = _spectrogramThread.getColorScheme();
+void InterfaceThread::_finishResize() {
+    _resizeThread.join();
+
+    /* Append rows received while resampling */
+    for (size_t i = 0; i < _magnitudeHistory.getCount(); i++) {
+        _resizeRow.assign(_magnitudeHistory.row(i), _magnitudeHistory.row(i) + _magnitudeHistory.getWidth());
+        _resizeResult.push(_resizeRow, _magnitudeHistory.time(i));
+    }
+
+    std::swap(_magnitudeHistory, _resizeResult);
+
+    /* Release old rows */
+    _resizeSource.resize(0, 0);
+    _resizeResult.resize(0, 0);
+    _resizing = false;
+
+    _renderPixels();
+}
+
+void InterfaceThread::_resampleHistory(size_t rows, size_t width) {
+    std::vector<uint16_t> row(width);
+
+    _resizeResult.resize(rows, width);
+
+    for (size_t i = 0; i < _resizeSource.getCount(); i++) {
+        if (_resizeCancel)
+            return;
+
+        SpectrumRenderer::resample(row, _resizeSource.row(i), _resizeSource.getWidth());
+        _resizeResult.push(row, _resizeSource.time(i));
+    }
+
+    _resizeDone = true;
 }
 
 void InterfaceThread::_renderSettings() {
@@ -229,18 +268,41 @@ void InterfaceThread::_renderSettings() {
     unsigned int overlap = static_cast<unsigned int>(_settings.samplesOverlap * 100.0);
 
     textSurfaces.push_back(renderString(format("Sample Rate: %d Hz", _settings.audioSampleRate), _font, settingsColor));
-    textSurfaces.push_back(renderString(format("Overlap: %d%%", overlap), _font, settingsColor));
+    if (_settings.dftEngine == SpectrumEngine::Type::SlidingDft)
+        textSurfaces.push_back(renderString(format("Hop: %u", _getHop()), _font, settingsColor));
+    else
+        textSurfaces.push_back(renderString(format("Overlap: %d%%", overlap), _font, settingsColor));
     textSurfaces.push_back(renderString("Window: " + to_string(_settings.dftWindowFunction), _font, settingsColor));
     textSurfaces.push_back(renderString(format("DFT Size: %d", _settings.dftSize), _font, settingsColor));
+    textSurfaces.push_back(renderString("Engine: " + to_string(_settings.dftEngine), _font, settingsColor));
+    if (_settings.zoomDecimation > 1)
+        textSurfaces.push_back(renderString(format("Zoom: %.0f Hz x%u", _settings.zoomFrequency, _settings.zoomDecimation), _font, settingsColor));
+    else if (_settings.dftEngine == SpectrumEngine::Type::ConstantQ)
+        textSurfaces.push_back(renderString(format("Bins/Octave: %u", _settings.cqtBinsPerOctave), _font, settingsColor));
+    else if (_settings.dftEngine == SpectrumEngine::Type::Polyphase)
+        textSurfaces.push_back(renderString(format("Taps: %u", _settings.pfbTaps), _font, settingsColor));
+    else if (_settings.dftEngine == SpectrumEngine::Type::Multitaper)
+        textSurfaces.push_back(renderString(format("Tapers: %u", _settings.multitaperTapers), _font, settingsColor));
+    else if (_settings.dftEngine == SpectrumEngine::Type::Goertzel)
+        textSurfaces.push_back(renderString(format("Tones: %u", static_cast<unsigned int>(_spectrogramThread.getGoertzelFrequencies().size())), _font, settingsColor));
+    else
+        textSurfaces.push_back(renderString("Axis: " + to_string(_settings.frequencyScale), _font, settingsColor));
+    textSurfaces.push_back(renderString("Average: " + to_string(_settings.averageMode), _font, settingsColor));
     textSurfaces.push_back(renderString(format("Colors: %s", to_string(_settings.colorScheme).c_str()), _font, settingsColor));
     if (_settings.magnitudeLog) {
         textSurfaces.push_back(renderString(format("Mag. min: %.2f dB", _settings.magnitudeMin), _font, settingsColor));
         textSurfaces.push_back(renderString(format("Mag. max: %.2f dB", _settings.magnitudeMax), _font, settingsColor));
-        textSurfaces.push_back(renderString(format("Mag. Logarithmic"), _font, settingsColor));
+        textSurfaces.push_back(renderString(_magnitudeAuto ? "Mag. Logarithmic, Auto" : "Mag. Logarithmic", _font, settingsColor));
     } else {
         textSurfaces.push_back(renderString(format("Mag. min: %.2f", _settings.magnitudeMin), _font, settingsColor));
         textSurfaces.push_back(renderString(format("Mag. max: %.2f", _settings.magnitudeMax), _font, settingsColor));
-        textSurfaces.push_back(renderString(format("Mag. Linear"), _font, settingsColor));
+        textSurfaces.push_back(renderString(_magnitudeAuto ? "Mag. Linear, Auto" : "Mag. Linear", _font, settingsColor));
+    }
+    if (_paused) {
+        /* Time back from the newest row, from row times, as the row duration may have changed since */
+        size_t count = _getHistoryCount();
+        double pausedTime = (count > _historyOffset) ? (_historyTime - _getHistoryTime(count - 1 - _historyOffset)) : 0.0;
+        textSurfaces.push_back(renderString(format("Paused: -%.1f s", pausedTime), _font, settingsColor));
     }
 
     settingsSurface = vcatSurfaces(textSurfaces, Alignment::Right);
@@ -263,22 +325,99 @@ void InterfaceThread::_renderSettings() {
     SDL_FreeSurface(settingsSurface);
 }
 
-void InterfaceThread::_renderCursor(int x, int y) {
-    SDL_Surface *cursorSurface;
-    SDL_Color settingsColor = {0xff, 0x00, 0x00, 0x00};
+float InterfaceThread::_getFrequency(int x, int y) {
+    float position;
+
+    /* Position along the frequency axis, from 0.0 to 1.0 */
+    if (_orientation == Orientation::Vertical)
+        position = static_cast<float>(x) / static_cast<float>(_width);
+    else
+        position = static_cast<float>(static_cast<int>(_height) - y) / static_cast<float>(_height);
+
+    if (_settings.zoomDecimation > 1) {
+        /* Complex DFT bins of the decimated baseband, centered on the zoom frequency */
+        float hzPerBin = (static_cast<float>(_settings.audioSampleRate) / static_cast<float>(_settings.zoomDecimation)) / static_cast<float>(_settings.dftSize);
+        float bin = std::floor(position * static_cast<float>(_settings.dftSize)) - static_cast<float>(_settings.dftSize / 2);
+        return _settings.zoomFrequency + bin * hzPerBin;
+    }
+
+    if (_settings.dftEngine == SpectrumEngine::Type::ConstantQ) {
+        /* Constant-Q bins, geometrically spaced from the lowest bin frequency */
+        float fmin = ConstantQTransform::getMinFrequency(_settings.dftSize, _settings.audioSampleRate, _settings.cqtBinsPerOctave, _settings.cqtMinFrequency);
+        unsigned int bins = ConstantQTransform::getBins(_settings.dftSize, _settings.audioSampleRate, _settings.cqtBinsPerOctave, _settings.cqtMinFrequency);
+        float bin = std::floor(position * static_cast<float>(bins));
+        return fmin * std::pow(2.0f, bin / static_cast<float>(_settings.cqtBinsPerOctave));
+    }
+
+    if (_settings.dftEngine == SpectrumEngine::Type::Goertzel) {
+        /* Goertzel tones, in equal strips */
+        const std::vector<float> &tones = _spectrogramThread.getGoertzelFrequencies();
+        size_t tone = std::min(static_cast<size_t>(position * static_cast<float>(tones.size())), tones.size() - 1);
+        return tones[tone];
+    }
 
-    float frequency;
+    /* Logarithmic and mel axes */
+    if (_settings.frequencyScale != FrequencyAxis::Scale::Linear)
+        return FrequencyAxis::getFrequency(_settings.frequencyScale, position, _settings.audioSampleRate);
 
     float hzPerBin = ((static_cast<float>(_settings.audioSampleRate)) / 2.0f) / static_cast<float>((_settings.dftSize / 2 + 1));
+    return std::floor(position * static_cast<float>((_settings.dftSize / 2 + 1))) * hzPerBin;
+}
 
-    if (_orientation == Orientation::Vertical) {
-        float binPerPixel = static_cast<float>((_settings.dftSize / 2 + 1)) / static_cast<float>(_width);
-        frequency = std::floor(static_cast<float>(x) * binPerPixel) * hzPerBin;
-    } else {
-        float binPerPixel = static_cast<float>((_settings.dftSize / 2 + 1)) / static_cast<float>(_height);
-        frequency = std::floor(static_cast<float>(static_cast<int>(_height) - y) * binPerPixel) * hzPerBin;
+void InterfaceThread::_startAutoRange() {
+    /* Seed the estimate from the visible rows */
+    size_t count = _getHistoryCount();
+    size_t rows = std::min<size_t>(count - _historyOffset, getTimeWidth());
+
+    _magnitudeRange.reset();
+    for (size_t i = 0; i < rows; i++)
+        _magnitudeRange.append(_getHistoryRow(count - _historyOffset - rows + i), getSpectrumWidth());
+}
+
+void InterfaceThread::_updateAutoRange() {
+    /* Wait for a row's worth of magnitudes */
+    if (_magnitudeRange.getCount() < static_cast<double>(getSpectrumWidth()))
+        return;
+
+    float magnitudeMin, magnitudeMax;
+    _magnitudeRange.getRange(magnitudeMin, magnitudeMax);
+
+    /* Favor recent rows */
+    _magnitudeRange.decay(AutoRangeDecay);
+
+    if (!_settings.magnitudeLog) {
+        magnitudeMin = std::pow(10.0f, magnitudeMin / 20.0f);
+        magnitudeMax = std::pow(10.0f, magnitudeMax / 20.0f);
     }
 
+    /* Ease toward the estimate */
+    float next_magnitudeMin = _settings.magnitudeMin + AutoRangeEasing * (magnitudeMin - _settings.magnitudeMin);
+    float next_magnitudeMax = _settings.magnitudeMax + AutoRangeEasing * (magnitudeMax - _settings.magnitudeMax);
+
+    /* Skip recoloring for changes too small to see */
+    float threshold = _settings.magnitudeLog ? 0.1f : 0.01f * (_settings.magnitudeMax - _settings.magnitudeMin);
+    if (std::abs(next_magnitudeMin - _settings.magnitudeMin) < threshold && std::abs(next_magnitudeMax - _settings.magnitudeMax) < threshold)
+        return;
+
+    _spectrumRenderer.setMagnitudeRange(next_magnitudeMin, next_magnitudeMax);
+    _settings.magnitudeMin = _spectrumRenderer.getMagnitudeMin();
+    _settings.magnitudeMax = _spectrumRenderer.getMagnitudeMax();
+    _renderPixels();
+
+    if (!_hideSettings)
+        _renderSettings();
+}
+
+unsigned int InterfaceThread::_getHop() {
+    return _settings.dftSize - static_cast<unsigned int>(_settings.samplesOverlap * static_cast<float>(_settings.dftSize));
+}
+
+void InterfaceThread::_renderCursor(int x, int y) {
+    SDL_Surface *cursorSurface;
+    SDL_Color settingsColor = {0xff, 0x00, 0x00, 0x00};
+
+    float frequency = _getFrequency(x, y);
+
     cursorSurface = renderString(format("%.0f Hz", frequency), _font, settingsColor);
 
     /* Update cursor rectangle destination for screen rendering */
@@ -305,10 +444,10 @@ void InterfaceThread::_renderStatistics() {
     SDL_Color statisticsColor = {0xff, 0x00, 0x00, 0x00};
 
     size_t samplesQueueCount = _spectrogramThread.getDebugSamplesQueueCount();
-    size_t pixelsQueueCount = _pixelsQueue.count();
+    size_t magnitudesQueueCount = _magnitudesQueue.count();
 
     textSurfaces.push_back(renderString(format("Audio Queue: %u", samplesQueueCount), _font, statisticsColor));
-    textSurfaces.push_back(renderString(format("Pixels Queue: %u", pixelsQueueCount), _font, statisticsColor));
+    textSurfaces.push_back(renderString(format("Magnitudes Queue: %u", magnitudesQueueCount), _font, statisticsColor));
     statisticsSurface = vcatSurfaces(textSurfaces, Alignment::Right);
 
     /* Update statistics rectangle destination for screen rendering */
@@ -329,6 +468,44 @@ void InterfaceThread::_renderStatistics() {
     SDL_FreeSurface(statisticsSurface);
 }
 
+void InterfaceThread::_renderLevels() {
+    std::vector<SDL_Surface *> textSurfaces;
+    SDL_Surface *levelsSurface;
+    SDL_Color levelsColor = {0xff, 0x00, 0x00, 0x00};
+
+    const std::vector<float> &tones = _spectrogramThread.getGoertzelFrequencies();
+    size_t count = _getHistoryCount();
+
+    /* Read levels of the newest visible row, at the center of each tone strip */
+    const uint16_t *row = (count > _historyOffset) ? _getHistoryRow(count - 1 - _historyOffset) : nullptr;
+    for (size_t i = 0; i < tones.size(); i++) {
+        if (row) {
+            size_t pixel = static_cast<size_t>((static_cast<float>(i) + 0.5f) * static_cast<float>(getSpectrumWidth()) / static_cast<float>(tones.size()));
+            textSurfaces.push_back(renderString(format("%.1f Hz: %.1f dB", tones[i], SpectrumRenderer::dequantize(row[pixel])), _font, levelsColor));
+        } else {
+            textSurfaces.push_back(renderString(format("%.1f Hz: -", tones[i]), _font, levelsColor));
+        }
+    }
+    levelsSurface = vcatSurfaces(textSurfaces, Alignment::Left);
+
+    /* Update levels rectangle destination for screen rendering */
+    _levelsRect.x = 5;
+    _levelsRect.y = 2;
+    _levelsRect.w = levelsSurface->w;
+    _levelsRect.h = levelsSurface->h;
+
+    /* Destroy old levels texture */
+    if (_levelsTexture)
+        SDL_DestroyTexture(_levelsTexture);
+
+    /* Create new texture from the target surface */
+    _levelsTexture = SDL_CreateTextureFromSurface(_renderer, levelsSurface);
+    if (_levelsTexture == nullptr)
+        throw SDLException("Error creating texture for levels text: SDL_CreateTextureFromSurface(): " + std::string(SDL_GetError()));
+
+    SDL_FreeSurface(levelsSurface);
+}
+
 void InterfaceThread::_renderHelp() {
     std::vector<SDL_Surface *> textSurfaces;
     SDL_Surface *textSurface;
@@ -346,18 +523,36 @@ void InterfaceThread::_renderHelp() {
     textSurfaces.push_back(renderString("c      Cycle color scheme", _font, helpColor));
     textSurfaces.push_back(renderString("w      Cycle window function", _font, helpColor));
     textSurfaces.push_back(renderString("l      Cycle linear/log magnitude", _font, helpColor));
+    textSurfaces.push_back(renderString("a      Cycle frequency axis", _font, helpColor));
+    textSurfaces.push_back(renderString("e      Cycle spectrum engine", _font, helpColor));
+    textSurfaces.push_back(renderString("b      Cycle constant-Q bins/octave", _font, helpColor));
+    textSurfaces.push_back(renderString("t      Cycle multitaper tapers", _font, helpColor));
+    textSurfaces.push_back(renderString("p      Cycle polyphase filterbank taps", _font, helpColor));
+    textSurfaces.push_back(renderString("v      Cycle averaging", _font, helpColor));
     textSurfaces.push_back(renderString(" ", _font, helpColor));
     textSurfaces.push_back(renderString("-      Decrease min magnitude", _font, helpColor));
     textSurfaces.push_back(renderString("=      Increase min magnitude", _font, helpColor));
     textSurfaces.push_back(renderString(" ", _font, helpColor));
     textSurfaces.push_back(renderString("[      Decrease max magnitude", _font, helpColor));
     textSurfaces.push_back(renderString("]      Increase max magnitude", _font, helpColor));
+    textSurfaces.push_back(renderString("r      Toggle auto magnitude range", _font, helpColor));
     textSurfaces.push_back(renderString(" ", _font, helpColor));
     textSurfaces.push_back(renderString("Left   Decrease DFT size", _font, helpColor));
     textSurfaces.push_back(renderString("Right  Increase DFT size", _font, helpColor));
     textSurfaces.push_back(renderString(" ", _font, helpColor));
     textSurfaces.push_back(renderString("Down   Decrease overlap", _font, helpColor));
     textSurfaces.push_back(renderString("Up     Increase overlap", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("z      Cycle zoom", _font, helpColor));
+    textSurfaces.push_back(renderString(",      Decrease zoom frequency", _font, helpColor));
+    textSurfaces.push_back(renderString(".      Increase zoom frequency", _font, helpColor));
+    textSurfaces.push_back(renderString("Click  Set zoom frequency", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("Space  Pause/resume", _font, helpColor));
+    textSurfaces.push_back(renderString("PgUp   Scroll back in history", _font, helpColor));
+    textSurfaces.push_back(renderString("PgDn   Scroll forward in history", _font, helpColor));
+    textSurfaces.push_back(renderString("Home   Jump to oldest history", _font, helpColor));
+    textSurfaces.push_back(renderString("End    Jump to live", _font, helpColor));
     textSurface = vcatSurfaces(textSurfaces, Alignment::Left);
 
     /* Create background surface */
@@ -408,8 +603,9 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
         else if (_settings.colorScheme == SpectrumRenderer::ColorScheme::Grayscale)
             next_colorScheme = SpectrumRenderer::ColorScheme::Heat;
 
-        _spectrogramThread.setColorScheme(next_colorScheme);
-        _settings.colorScheme = _spectrogramThread.getColorScheme();
+        _spectrumRenderer.setColorScheme(next_colorScheme);
+        _settings.colorScheme = _spectrumRenderer.getColorScheme();
+        _renderPixels();
     } else if (state[SDL_SCANCODE_W]) {
         /* Change window function */
         RealDft::WindowFunction next_wf = RealDft::WindowFunction::Hann;
@@ -429,17 +625,18 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
         /* Toggle between Logarithimic/Linear */
         bool next_magnitudeLog = !_settings.magnitudeLog;
 
-        _spectrogramThread.setMagnitudeLog(next_magnitudeLog);
+        _spectrumRenderer.setMagnitudeLog(next_magnitudeLog);
         _settings.magnitudeLog = next_magnitudeLog;
         if (next_magnitudeLog) {
-            _spectrogramThread.setMagnitudeMin(InitialSettings.magnitudeLogMin);
-            _spectrogramThread.setMagnitudeMax(InitialSettings.magnitudeLogMax);
+            _spectrumRenderer.setMagnitudeMin(InitialSettings.magnitudeLogMin);
+            _spectrumRenderer.setMagnitudeMax(InitialSettings.magnitudeLogMax);
         } else {
-            _spectrogramThread.setMagnitudeMin(InitialSettings.magnitudeLinearMin);
-            _spectrogramThread.setMagnitudeMax(InitialSettings.magnitudeLinearMax);
+            _spectrumRenderer.setMagnitudeMin(InitialSettings.magnitudeLinearMin);
+            _spectrumRenderer.setMagnitudeMax(InitialSettings.magnitudeLinearMax);
         }
-        _settings.magnitudeMin = _spectrogramThread.getMagnitudeMin();
-        _settings.magnitudeMax = _spectrogramThread.getMagnitudeMax();
+        _settings.magnitudeMin = _spectrumRenderer.getMagnitudeMin();
+        _settings.magnitudeMax = _spectrumRenderer.getMagnitudeMax();
+        _renderPixels();
     } else if (state[SDL_SCANCODE_RIGHT]) {
         /* DFT N up */
         unsigned int next_dftSize = std::min<unsigned int>(_settings.dftSize * 2, UserLimits.dftSizeMax);
@@ -468,6 +665,13 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
 
         _settings.dftSize = _spectrogramThread.getDftSize();
         _settings.samplesOverlap = _spectrogramThread.getSamplesOverlap();
+    } else if ((state[SDL_SCANCODE_DOWN] || state[SDL_SCANCODE_UP]) && _settings.dftEngine == SpectrumEngine::Type::SlidingDft) {
+        /* Samples hop down/up by a factor of two, from one sample to half the DFT size */
+        unsigned int hop = _getHop();
+        unsigned int next_hop = state[SDL_SCANCODE_UP] ? std::max<unsigned int>(hop / 2, 1) : std::min<unsigned int>(hop * 2, _settings.dftSize / 2);
+
+        _spectrogramThread.setSamplesOverlap(static_cast<float>(_settings.dftSize - next_hop) / static_cast<float>(_settings.dftSize));
+        _settings.samplesOverlap = _spectrogramThread.getSamplesOverlap();
     } else if (state[SDL_SCANCODE_DOWN]) {
         /* Samples Overlap Up */
         float next_samplesOverlap = std::max<float>(_settings.samplesOverlap - UserLimits.samplesOverlapStep, UserLimits.samplesOverlapMin);
@@ -480,6 +684,98 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
 
         _spectrogramThread.setSamplesOverlap(next_samplesOverlap);
         _settings.samplesOverlap = _spectrogramThread.getSamplesOverlap();
+    } else if (state[SDL_SCANCODE_A]) {
+        /* Cycle frequency axis scale */
+        FrequencyAxis::Scale next_frequencyScale = FrequencyAxis::Scale::Linear;
+
+        if (_settings.frequencyScale == FrequencyAxis::Scale::Linear)
+            next_frequencyScale = FrequencyAxis::Scale::Logarithmic;
+        else if (_settings.frequencyScale == FrequencyAxis::Scale::Logarithmic)
+            next_frequencyScale = FrequencyAxis::Scale::Mel;
+        else if (_settings.frequencyScale == FrequencyAxis::Scale::Mel)
+            next_frequencyScale = FrequencyAxis::Scale::Linear;
+
+        _spectrogramThread.setFrequencyScale(next_frequencyScale);
+        _settings.frequencyScale = _spectrogramThread.getFrequencyScale();
+    } else if (state[SDL_SCANCODE_E]) {
+        /* Cycle spectrum engine */
+        SpectrumEngine::Type next_engine = SpectrumEngine::Type::Dft;
+
+        if (_settings.dftEngine == SpectrumEngine::Type::Dft)
+            next_engine = SpectrumEngine::Type::Polyphase;
+        else if (_settings.dftEngine == SpectrumEngine::Type::Polyphase)
+            next_engine = SpectrumEngine::Type::ConstantQ;
+        else if (_settings.dftEngine == SpectrumEngine::Type::ConstantQ)
+            next_engine = SpectrumEngine::Type::Multitaper;
+        else if (_settings.dftEngine == SpectrumEngine::Type::Multitaper)
+            next_engine = SpectrumEngine::Type::SlidingDft;
+        else if (_settings.dftEngine == SpectrumEngine::Type::SlidingDft && !_spectrogramThread.getGoertzelFrequencies().empty())
+            next_engine = SpectrumEngine::Type::Goertzel;
+        else if (_settings.dftEngine == SpectrumEngine::Type::SlidingDft)
+            next_engine = SpectrumEngine::Type::Dft;
+        else if (_settings.dftEngine == SpectrumEngine::Type::Goertzel)
+            next_engine = SpectrumEngine::Type::Dft;
+
+        _spectrogramThread.setEngine(next_engine);
+        _settings.dftEngine = _spectrogramThread.getEngine();
+    } else if (state[SDL_SCANCODE_B]) {
+        /* Cycle constant-Q bins per octave in steps of 12, wrapping to the minimum */
+        unsigned int next_cqtBinsPerOctave = _settings.cqtBinsPerOctave + 12;
+
+        if (next_cqtBinsPerOctave > UserLimits.cqtBinsPerOctaveMax)
+            next_cqtBinsPerOctave = UserLimits.cqtBinsPerOctaveMin;
+
+        _spectrogramThread.setCqtBinsPerOctave(next_cqtBinsPerOctave);
+        _settings.cqtBinsPerOctave = _spectrogramThread.getCqtBinsPerOctave();
+    } else if (state[SDL_SCANCODE_T]) {
+        /* Cycle multitaper tapers in steps of two, wrapping to the minimum */
+        unsigned int next_multitaperTapers = _settings.multitaperTapers + 2;
+
+        if (next_multitaperTapers > UserLimits.multitaperTapersMax)
+            next_multitaperTapers = UserLimits.multitaperTapersMin;
+
+        _spectrogramThread.setMultitaperTapers(next_multitaperTapers);
+        _settings.multitaperTapers = _spectrogramThread.getMultitaperTapers();
+    } else if (state[SDL_SCANCODE_P]) {
+        /* Cycle polyphase filterbank taps by doubling, wrapping to the minimum */
+        unsigned int next_pfbTaps = _settings.pfbTaps * 2;
+
+        if (next_pfbTaps > UserLimits.pfbTapsMax)
+            next_pfbTaps = UserLimits.pfbTapsMin;
+
+        _spectrogramThread.setPfbTaps(next_pfbTaps);
+        _settings.pfbTaps = _spectrogramThread.getPfbTaps();
+    } else if (state[SDL_SCANCODE_V]) {
+        /* Cycle averaging mode */
+        SpectrumAverager::Mode next_averageMode = SpectrumAverager::Mode::None;
+
+        if (_settings.averageMode == SpectrumAverager::Mode::None)
+            next_averageMode = SpectrumAverager::Mode::Exponential;
+        else if (_settings.averageMode == SpectrumAverager::Mode::Exponential)
+            next_averageMode = SpectrumAverager::Mode::Boxcar;
+        else if (_settings.averageMode == SpectrumAverager::Mode::Boxcar)
+            next_averageMode = SpectrumAverager::Mode::PeakHold;
+        else if (_settings.averageMode == SpectrumAverager::Mode::PeakHold)
+            next_averageMode = SpectrumAverager::Mode::None;
+
+        _spectrogramThread.setAverageMode(next_averageMode);
+        _settings.averageMode = _spectrogramThread.getAverageMode();
+    } else if (state[SDL_SCANCODE_Z]) {
+        /* Cycle zoom decimation, doubling up to the limit and then off */
+        unsigned int next_zoomDecimation = _settings.zoomDecimation * 2;
+
+        if (next_zoomDecimation > UserLimits.zoomDecimationMax)
+            next_zoomDecimation = 1;
+
+        _spectrogramThread.setZoomDecimation(next_zoomDecimation);
+        _settings.zoomDecimation = _spectrogramThread.getZoomDecimation();
+    } else if (state[SDL_SCANCODE_COMMA] || state[SDL_SCANCODE_PERIOD]) {
+        /* Zoom center frequency down/up by a tenth of the zoomed span */
+        float step = static_cast<float>(_settings.audioSampleRate) / static_cast<float>(_settings.zoomDecimation) / 10.0f;
+        float next_zoomFrequency = _settings.zoomFrequency + (state[SDL_SCANCODE_COMMA] ? -step : step);
+
+        _spectrogramThread.setZoomFrequency(next_zoomFrequency);
+        _settings.zoomFrequency = _spectrogramThread.getZoomFrequency();
     } else if (state[SDL_SCANCODE_MINUS]) {
         /* Magnitude min down */
         float next_magnitudeMin;
@@ -489,8 +785,10 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
         else
             next_magnitudeMin = std::max<float>(_settings.magnitudeMin - UserLimits.magnitudeLinearStep, UserLimits.magnitudeLinearMin);
 
-        _spectrogramThread.setMagnitudeMin(next_magnitudeMin);
-        _settings.magnitudeMin = _spectrogramThread.getMagnitudeMin();
+        _spectrumRenderer.setMagnitudeMin(next_magnitudeMin);
+        _settings.magnitudeMin = _spectrumRenderer.getMagnitudeMin();
+        _magnitudeAuto = false;
+        _renderPixels();
     } else if (state[SDL_SCANCODE_EQUALS]) {
         /* Magnitude min up */
         float next_magnitudeMin;
@@ -500,8 +798,10 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
         else
             next_magnitudeMin = std::min<float>(_settings.magnitudeMin + UserLimits.magnitudeLinearStep, _settings.magnitudeMax - UserLimits.magnitudeLinearStep);
 
-        _spectrogramThread.setMagnitudeMin(next_magnitudeMin);
-        _settings.magnitudeMin = _spectrogramThread.getMagnitudeMin();
+        _spectrumRenderer.setMagnitudeMin(next_magnitudeMin);
+        _settings.magnitudeMin = _spectrumRenderer.getMagnitudeMin();
+        _magnitudeAuto = false;
+        _renderPixels();
     } else if (state[SDL_SCANCODE_LEFTBRACKET]) {
         /* Magnitude max down */
         float next_magnitudeMax;
@@ -511,8 +811,10 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
         else
             next_magnitudeMax = std::max<float>(_settings.magnitudeMax - UserLimits.magnitudeLinearStep, _settings.magnitudeMin + UserLimits.magnitudeLinearStep);
 
-        _spectrogramThread.setMagnitudeMax(next_magnitudeMax);
-        _settings.magnitudeMax = _spectrogramThread.getMagnitudeMax();
+        _spectrumRenderer.setMagnitudeMax(next_magnitudeMax);
+        _settings.magnitudeMax = _spectrumRenderer.getMagnitudeMax();
+        _magnitudeAuto = false;
+        _renderPixels();
     } else if (state[SDL_SCANCODE_RIGHTBRACKET]) {
         /* Magnitude max up */
         float next_magnitudeMax;
@@ -522,8 +824,38 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
         else
             next_magnitudeMax = std::min<float>(_settings.magnitudeMax + UserLimits.magnitudeLinearStep, UserLimits.magnitudeLinearMax);
 
-        _spectrogramThread.setMagnitudeMax(next_magnitudeMax);
-        _settings.magnitudeMax = _spectrogramThread.getMagnitudeMax();
+        _spectrumRenderer.setMagnitudeMax(next_magnitudeMax);
+        _settings.magnitudeMax = _spectrumRenderer.getMagnitudeMax();
+        _magnitudeAuto = false;
+        _renderPixels();
+    } else if (state[SDL_SCANCODE_R]) {
+        /* Toggle auto magnitude range */
+        _magnitudeAuto = !_magnitudeAuto;
+        if (_magnitudeAuto)
+            _startAutoRange();
+    } else if (state[SDL_SCANCODE_SPACE]) {
+        /* Toggle pause, resuming at live */
+        if (_paused) {
+            _paused = false;
+            _historyOffset = 0;
+            _renderPixels();
+        } else {
+            _paused = true;
+        }
+    } else if (state[SDL_SCANCODE_PAGEUP]) {
+        /* Scroll back one screen */
+        _scrollHistory(static_cast<long>(getTimeWidth()));
+    } else if (state[SDL_SCANCODE_PAGEDOWN]) {
+        /* Scroll forward one screen */
+        _scrollHistory(-static_cast<long>(getTimeWidth()));
+    } else if (state[SDL_SCANCODE_HOME]) {
+        /* Jump to oldest history */
+        _scrollHistory(static_cast<long>(_getHistoryCount()));
+    } else if (state[SDL_SCANCODE_END]) {
+        /* Jump to live */
+        _paused = false;
+        _historyOffset = 0;
+        _renderPixels();
     } else if (state[SDL_SCANCODE_S]) {
         /* Hide info */
         _hideSettings = !_hideSettings;
@@ -556,17 +888,24 @@ void InterfaceThread::_handleKeyDown(const uint8_t *state) {
         return;
     }
 
+    /* Resize history if the row duration changed */
+    _updateHistoryRows();
+
     _renderSettings();
 }
 
 void InterfaceThread::run() {
-    std::vector<uint32_t> pixels(_width * _height * sizeof(uint32_t));
     std::vector<uint32_t> newPixels;
 
     auto statisticsTic = std::chrono::system_clock::now();
+    auto pausedTic = std::chrono::system_clock::now();
+    auto levelsTic = std::chrono::system_clock::now();
+    auto autoRangeTic = std::chrono::system_clock::now();
 
     /* Poll current settings */
     _updateSettings();
+    /* Size history with the polled settings */
+    _updateHistoryRows();
     /* Render settings */
     _renderSettings();
     /* Render statistics */
@@ -583,20 +922,36 @@ void InterfaceThread::run() {
             } else if (e.type == SDL_KEYDOWN) {
                 const uint8_t *state = SDL_GetKeyboardState(nullptr);
                 _handleKeyDown(state);
+            } else if (e.type == SDL_MOUSEWHEEL) {
+                /* Scroll history by a tenth of a screen per wheel step */
+                _scrollHistory(static_cast<long>(e.wheel.y) * static_cast<long>(std::max(getTimeWidth() / 10, 1u)));
+                if (!_hideSettings)
+                    _renderSettings();
+            } else if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
+                /* Center zoom on clicked frequency */
+                _spectrogramThread.setZoomFrequency(_getFrequency(e.button.x, e.button.y));
+                _settings.zoomFrequency = _spectrogramThread.getZoomFrequency();
+                if (!_hideSettings)
+                    _renderSettings();
             } else if (e.type == SDL_MOUSEMOTION) {
                 int mx, my;
                 SDL_GetMouseState(&mx, &my);
                 _renderCursor(mx, my);
             } else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_RESIZED) {
+                unsigned int oldSpectrumWidth = getSpectrumWidth(), oldTimeWidth = getTimeWidth();
+
                 _width = static_cast<unsigned int>(e.window.data1);
                 _height = static_cast<unsigned int>(e.window.data2);
 
                 /* Update spectrogram thread with new width */
                 _spectrogramThread.setWidth(getSpectrumWidth());
 
-                /* Resize and re-initialize pixel buffer */
-                pixels.resize(_width * _height * sizeof(uint32_t));
-                std::fill(pixels.begin(), pixels.end(), 0);
+                /* Resample magnitude history to new width in the background */
+                if (getSpectrumWidth() != oldSpectrumWidth || std::max(_historyRows, static_cast<size_t>(getTimeWidth())) != std::max(_historyRows, static_cast<size_t>(oldTimeWidth)))
+                    _startResize();
+
+                /* Resize pixel buffer */
+                _pixels.resize(_width * _height);
 
                 /* Resize pixels texture */
                 if (_pixelsTexture)
@@ -606,6 +961,9 @@ void InterfaceThread::run() {
                 if (_pixelsTexture == nullptr)
                     throw SDLException("Creating SDL texture: SDL_CreateTexture(): " + std::string(SDL_GetError()));
 
+                /* Redraw visible rows from history */
+                _renderPixels();
+
                 /* Re-render settings */
                 if (!_hideSettings)
                     _renderSettings();
@@ -631,19 +989,67 @@ void InterfaceThread::run() {
             statisticsTic = std::chrono::system_clock::now();
         }
 
-        /* Collect all new pixel rows */
-        while (!_pixelsQueue.empty()) {
-            std::vector<uint32_t> pixelRow(_pixelsQueue.pop());
+        /* Update tone levels every 250ms */
+        bool showLevels = !_hideSettings && _settings.dftEngine == SpectrumEngine::Type::Goertzel;
+        if (showLevels && (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - levelsTic).count() > 250)) {
+            _renderLevels();
+            levelsTic = std::chrono::system_clock::now();
+        }
 
-            /* If we encounter an old pixel row, replace with empty row */
-            if (pixelRow.size() != getSpectrumWidth()) {
-                pixelRow.resize(getSpectrumWidth());
-                std::fill(pixelRow.begin(), pixelRow.end(), 0);
+        /* Update auto magnitude range */
+        if (_magnitudeAuto && (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - autoRangeTic).count() > AutoRangeInterval)) {
+            _updateAutoRange();
+            autoRangeTic = std::chrono::system_clock::now();
+        }
+
+        /* Update paused position every 500ms */
+        if (_paused && !_hideSettings && (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - pausedTic).count() > 500)) {
+            _renderSettings();
+            pausedTic = std::chrono::system_clock::now();
+        }
+
+        /* Swap in resampled history */
+        if (_resizing && _resizeDone)
+            _finishResize();
+
+        /* Collect all new magnitude rows */
+        bool pausedRowsExpired = false;
+        while (!_magnitudesQueue.empty()) {
+            std::vector<uint16_t> magnitudeRow(_magnitudesQueue.pop());
+
+            /* If we encounter a magnitude row of an old width, resample it */
+            if (magnitudeRow.size() != getSpectrumWidth()) {
+                std::vector<uint16_t> resampledRow(getSpectrumWidth());
+                SpectrumRenderer::resample(resampledRow, magnitudeRow.data(), magnitudeRow.size());
+                magnitudeRow.swap(resampledRow);
+            }
+
+            /* Add to magnitude history */
+            _historyTime += _getRowDuration();
+            _magnitudeHistory.push(magnitudeRow, _historyTime);
+
+            /* Count magnitudes for auto range */
+            if (_magnitudeAuto)
+                _magnitudeRange.append(magnitudeRow.data(), magnitudeRow.size());
+
+            if (_paused) {
+                /* Hold paused view on the same rows, until they expire from history */
+                if (_historyOffset + getTimeWidth() < _getHistoryCount())
+                    _historyOffset++;
+                else
+                    pausedRowsExpired = true;
+                continue;
             }
 
-            newPixels.insert(newPixels.end(), pixelRow.begin(), pixelRow.end());
+            /* Color new pixel row */
+            newPixels.resize(newPixels.size() + magnitudeRow.size());
+            _spectrumRenderer.render(newPixels.data() + newPixels.size() - magnitudeRow.size(), magnitudeRow.data(), magnitudeRow.size());
         }
 
+        /* Recolor paused view if it slid forward */
+        if (pausedRowsExpired)
+            _renderPixels();
+
         /* Update pixel buffer with new pixels */
         if (newPixels.size() > 0) {
             uint32_t *data = newPixels.data();
@@ -652,20 +1058,20 @@ void InterfaceThread::run() {
             if (size > _width * _height) {
                 /* Pixel buffer overrun (this should seldom happen). */
                 /* Use the last width*height pixels */
-                data = newPixels.data() + (_width * _height - size);
+                data = newPixels.data() + (size - _width * _height);
                 size = _width * _height;
             }
 
             /* Move old pixels up */
-            memmove(pixels.data(), pixels.data() + size, (_width * _height - size) * sizeof(uint32_t));
+            memmove(_pixels.data(), _pixels.data() + size, (_width * _height - size) * sizeof(uint32_t));
 
             /* Copy new pixels over */
-            memcpy(pixels.data() + (_width * _height - size), data, size * sizeof(uint32_t));
+            memcpy(_pixels.data() + (_width * _height - size), data, size * sizeof(uint32_t));
 
             /* Clear new pixels */
             newPixels.clear();
 
-            SDL_UpdateTexture(_pixelsTexture, nullptr, pixels.data(), static_cast<int>(getSpectrumWidth() * sizeof(uint32_t)));
+            SDL_UpdateTexture(_pixelsTexture, nullptr, _pixels.data(), static_cast<int>(getSpectrumWidth() * sizeof(uint32_t)));
         }
 
         SDL_RenderClear(_renderer);
@@ -684,6 +1090,11 @@ void InterfaceThread::run() {
             SDL_RenderCopy(_renderer, _cursorTexture, nullptr, &_cursorRect);
         }
 
+        /* Render tone levels */
+        if (showLevels && _levelsTexture) {
+            SDL_RenderCopy(_renderer, _levelsTexture, nullptr, &_levelsRect);
+        }
+
         /* Render statistics */
         if (!_hideStatistics) {
             SDL_RenderCopy(_renderer, _statisticsTexture, nullptr, &_statisticsRect);
@@ -1,34 +1,71 @@
 #pragma once
 
 #include <stdexcept>
+#include <thread>
+#include <atomic>
 
 #include <SDL.h>
 #include <SDL_ttf.h>
 
 #include "ThreadSafeQueue.hpp"
+#include "InterfaceHelpers.hpp"
+#include "spectrogram/SpectrumRenderer.hpp"
+#include "spectrogram/MagnitudeHistory.hpp"
+#include "spectrogram/MagnitudeRange.hpp"
 #include "AudioThread.hpp"
 #include "SpectrogramThread.hpp"
 #include "Configuration.hpp"
 
 class InterfaceThread {
   public:
-    InterfaceThread(ThreadSafeQueue<std::vector<uint32_t>> &pixelsQueue, AudioThread &audioThread, SpectrogramThread &spectrogramThread, const Configuration::Settings &initialSettings);
+    InterfaceThread(ThreadSafeQueue<std::vector<uint16_t>> &magnitudesQueue, AudioThread &audioThread, SpectrogramThread &spectrogramThread, const Configuration::Settings &initialSettings);
     ~InterfaceThread();
 
     void run();
 
   private:
+    /* Auto range update interval, histogram decay per update, and easing toward the estimate */
+    static constexpr unsigned int AutoRangeInterval = 250;
+    static constexpr float AutoRangeDecay = 0.975f;
+    static constexpr float AutoRangeEasing = 0.3f;
+
     inline unsigned int getSpectrumWidth() { return (_orientation == Configuration::Orientation::Vertical) ? _width : _height; }
     inline unsigned int getTimeWidth() { return (_orientation == Configuration::Orientation::Vertical) ? _height : _width; }
 
-    /* Pixels input queue */
-    ThreadSafeQueue<std::vector<uint32_t>> &_pixelsQueue;
+    /* Quantized magnitudes input queue */
+    ThreadSafeQueue<std::vector<uint16_t>> &_magnitudesQueue;
     /* References to other threads for control */
     AudioThread &_audioThread;
     SpectrogramThread &_spectrogramThread;
     /* Running boolean */
     bool _running;
 
+    /* Spectrum renderer for coloring magnitudes */
+    Spectrogram::SpectrumRenderer _spectrumRenderer;
+    /* Quantized magnitudes of visible and scrollback rows */
+    Spectrogram::MagnitudeHistory _magnitudeHistory;
+    /* Noise floor and peak estimate for auto range */
+    Spectrogram::MagnitudeRange _magnitudeRange;
+    /* History capacity in rows, for the history duration at the current row duration */
+    size_t _historyRows;
+    const unsigned int _historyDuration;
+    /* Time of the newest row in seconds, advanced by each row's duration */
+    double _historyTime = 0.0;
+    /* Scrollback offset from newest row, paused boolean */
+    size_t _historyOffset = 0;
+    bool _paused = false;
+    /* Colored pixels of visible rows */
+    std::vector<uint32_t> _pixels;
+
+    /* Background resampling of history to a new spectrum width on resize */
+    Spectrogram::MagnitudeHistory _resizeSource;
+    Spectrogram::MagnitudeHistory _resizeResult;
+    std::vector<uint16_t> _resizeRow;
+    std::thread _resizeThread;
+    std::atomic<bool> _resizeCancel;
+    std::atomic<bool> _resizeDone;
+    bool _resizing = false;
+
     /* Owned resources (SDL) */
     SDL_Window *_win = nullptr;
     SDL_Renderer *_renderer = nullptr;
@@ -37,10 +74,12 @@ class InterfaceThread {
     SDL_Texture *_cursorTexture = nullptr;
     SDL_Texture *_statisticsTexture = nullptr;
     SDL_Texture *_helpTexture = nullptr;
+    SDL_Texture *_levelsTexture = nullptr;
     SDL_Rect _settingsRect;
     SDL_Rect _cursorRect;
     SDL_Rect _statisticsRect;
     SDL_Rect _helpRect;
+    SDL_Rect _levelsRect;
     TTF_Font *_font = nullptr;
 
     /* Interface settings */
@@ -50,13 +89,29 @@ class InterfaceThread {
     bool _hideSettings = false;
     bool _hideStatistics = true;
     bool _hideHelp = true;
+    bool _magnitudeAuto;
 
     /* Helper functions for SDL */
     void _handleKeyDown(const uint8_t *state);
     void _updateSettings();
+    void _renderPixels();
+    void _scrollHistory(long rows);
+    size_t _getHistoryCount();
+    const uint16_t *_getHistoryRow(size_t index);
+    double _getHistoryTime(size_t index);
+    double _getRowDuration();
+    void _updateHistoryRows();
+    void _startResize();
+    void _finishResize();
+    void _resampleHistory(size_t rows, size_t width);
     void _renderSettings();
     void _renderCursor(int x, int y);
+    float _getFrequency(int x, int y);
+    unsigned int _getHop();
     void _renderStatistics();
+    void _renderLevels();
+    void _startAutoRange();
+    void _updateAutoRange();
     void _renderHelp();
 
     /* Cached settings from audio source, dft, and spectrogram classes */
@@ -65,19 +120,18 @@ class InterfaceThread {
         float samplesOverlap;
         DFT::RealDft::WindowFunction dftWindowFunction;
         unsigned int dftSize;
+        DFT::SpectrumEngine::Type dftEngine;
+        unsigned int cqtBinsPerOctave;
+        float cqtMinFrequency;
+        unsigned int multitaperTapers;
+        unsigned int pfbTaps;
+        Spectrogram::SpectrumAverager::Mode averageMode;
+        float zoomFrequency;
+        unsigned int zoomDecimation;
+        Spectrogram::FrequencyAxis::Scale frequencyScale;
         float magnitudeMin;
         float magnitudeMax;
         bool magnitudeLog;
         Spectrogram::SpectrumRenderer::ColorScheme colorScheme;
     } _settings;
 };
-
-class SDLException : public std::runtime_error {
-  public:
-    using std::runtime_error::runtime_error;
-};
-
-class TTFException : public std::runtime_error {
-  public:
-    using std::runtime_error::runtime_error;
-};
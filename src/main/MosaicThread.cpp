@@ -0,0 +1,425 @@
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "MosaicThread.hpp"
+#include "Configuration.hpp"
+
+using namespace DFT;
+using namespace Spectrogram;
+using namespace Configuration;
+
+/* Tile settings: source sample rate, tile dimensions, no per-tile frame workers, and no frame ring */
+static Settings tileSettings(const Settings &initialSettings, const AudioSourceSettings &source, unsigned int width, unsigned int height) {
+    Settings settings = initialSettings;
+
+    if (source.sampleRate != 0)
+        settings.audioSampleRate = source.sampleRate;
+    settings.width = width;
+    settings.height = height;
+    settings.dftThreads = 1;
+    settings.frameRingName = "";
+
+    return settings;
+}
+
+MosaicThread::Tile::Tile(const Settings &settings, const AudioSourceSettings &source) : label((source.device == "") ? "default" : source.device), sampleRate(settings.audioSampleRate), audioThread(samplesQueue, settings, source.device), spectrogramThread(samplesQueue, magnitudesQueue, settings), spectrumRenderer(settings.magnitudeMin, settings.magnitudeMax, settings.magnitudeLog, settings.colorScheme), busy(false) {
+    spectrumWidth = (settings.orientation == Orientation::Vertical) ? settings.width : settings.height;
+    timeWidth = (settings.orientation == Orientation::Vertical) ? settings.height : settings.width;
+    pixels.resize(spectrumWidth * timeWidth);
+}
+
+MosaicThread::MosaicThread(const Settings &initialSettings) : _threadPool(ThreadPool::defaultThreads()), _fullscreen(initialSettings.fullscreen), _width(initialSettings.width), _height(initialSettings.height), _orientation(initialSettings.orientation) {
+    int ret;
+
+    /* Initialize SDL */
+    ret = SDL_Init(SDL_INIT_VIDEO);
+    if (ret < 0)
+        throw SDLException("Unable to initialize SDL: SDL_Init(): " + std::string(SDL_GetError()));
+
+    /* Initialize TTF */
+    ret = TTF_Init();
+    if (ret < 0)
+        throw TTFException("Unable to initialize TTF: TTF_Init(): " + std::string(TTF_GetError()));
+
+    /* Query resolution for fullscreen mode */
+    if (_fullscreen) {
+        SDL_DisplayMode displayMode;
+        if (SDL_GetDesktopDisplayMode(0, &displayMode) < 0)
+            throw SDLException("Querying display mode: SDL_GetDesktopDisplayMode(): " + std::string(SDL_GetError()));
+
+        _width = static_cast<unsigned int>(displayMode.w);
+        _height = static_cast<unsigned int>(displayMode.h);
+    }
+
+    /* Near-square grid of tiles */
+    unsigned int count = static_cast<unsigned int>(initialSettings.audioSources.size());
+    _columns = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(count))));
+    _rows = (count + _columns - 1) / _columns;
+
+    /* Open audio sources */
+    for (const AudioSourceSettings &source : initialSettings.audioSources)
+        _tiles.emplace_back(new Tile(tileSettings(initialSettings, source, std::max(_width / _columns, 1u), std::max(_height / _rows, 1u)), source));
+
+    /* Create Window */
+    _win = SDL_CreateWindow("audioprism", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, static_cast<int>(_width), static_cast<int>(_height), SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL | (_fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0));
+    if (_win == nullptr)
+        throw SDLException("Creating SDL window: SDL_CreateWindow(): " + std::string(SDL_GetError()));
+
+    /* Create Renderer */
+    _renderer = SDL_CreateRenderer(_win, -1, SDL_RENDERER_ACCELERATED);
+    if (_renderer == nullptr)
+        throw SDLException("Creating SDL renderer: SDL_CreateRenderer(): " + std::string(SDL_GetError()));
+
+    /* Find a compatible font */
+    std::string fontPath = findFontPath();
+    if (fontPath == "")
+        throw TTFException("Could not find a compatible TTF font.");
+
+    /* Open font */
+    _font = TTF_OpenFont(fontPath.c_str(), 11);
+    if (_font == nullptr)
+        throw TTFException("Opening TTF font: TTF_OpenFont(): " + std::string(TTF_GetError()));
+
+    /* Create tile textures */
+    _layoutTiles();
+}
+
+MosaicThread::~MosaicThread() {
+    /* Stop audio threads, which run() leaves running when it throws, as a joinable thread must not be destroyed */
+    for (std::unique_ptr<Tile> &tile : _tiles)
+        tile->audioThread.stop();
+
+    /* Finish worker tasks before tiles are destroyed */
+    _threadPool.clear();
+    try {
+        _threadPool.wait();
+    } catch (...) {
+    }
+
+    for (std::unique_ptr<Tile> &tile : _tiles) {
+        if (tile->pixelsTexture)
+            SDL_DestroyTexture(tile->pixelsTexture);
+        if (tile->labelTexture)
+            SDL_DestroyTexture(tile->labelTexture);
+    }
+
+    TTF_CloseFont(_font);
+    SDL_DestroyRenderer(_renderer);
+    SDL_DestroyWindow(_win);
+    TTF_Quit();
+    SDL_Quit();
+}
+
+void MosaicThread::_process(Tile &tile) {
+    tile.busy = true;
+
+    _threadPool.submit([this, &tile](unsigned int) {
+        try {
+            /* Compute spectra of queued samples */
+            tile.spectrogramThread.process();
+
+            std::lock_guard<std::mutex> lg(tile.lock);
+
+            /* Color new magnitude rows */
+            while (!tile.magnitudesQueue.empty()) {
+                std::vector<uint16_t> magnitudeRow(tile.magnitudesQueue.pop());
+
+                /* If we encounter a magnitude row of an old width, resample it */
+                if (magnitudeRow.size() != tile.spectrumWidth) {
+                    std::vector<uint16_t> resampledRow(tile.spectrumWidth);
+                    SpectrumRenderer::resample(resampledRow, magnitudeRow.data(), magnitudeRow.size());
+                    magnitudeRow.swap(resampledRow);
+                }
+
+                tile.newPixels.resize(tile.newPixels.size() + magnitudeRow.size());
+                tile.spectrumRenderer.render(tile.newPixels.data() + tile.newPixels.size() - magnitudeRow.size(), magnitudeRow.data(), magnitudeRow.size());
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lg(_exceptionLock);
+            if (!_exception)
+                _exception = std::current_exception();
+        }
+
+        tile.busy = false;
+    });
+}
+
+void MosaicThread::_layoutTiles() {
+    unsigned int tileWidth = std::max(_width / _columns, 1u);
+    unsigned int tileHeight = std::max(_height / _rows, 1u);
+
+    for (size_t i = 0; i < _tiles.size(); i++) {
+        Tile &tile = *_tiles[i];
+
+        tile.rect = {static_cast<int>((i % _columns) * tileWidth), static_cast<int>((i / _columns) * tileHeight), static_cast<int>(tileWidth), static_cast<int>(tileHeight)};
+
+        unsigned int spectrumWidth = (_orientation == Orientation::Vertical) ? tileWidth : tileHeight;
+        unsigned int timeWidth = (_orientation == Orientation::Vertical) ? tileHeight : tileWidth;
+
+        if (tile.pixelsTexture == nullptr || spectrumWidth != tile.spectrumWidth || timeWidth != tile.timeWidth) {
+            /* Update spectrogram with new width */
+            tile.spectrogramThread.setWidth(spectrumWidth);
+
+            {
+                std::lock_guard<std::mutex> lg(tile.lock);
+                tile.spectrumWidth = spectrumWidth;
+                tile.newPixels.clear();
+            }
+
+            /* Restart pixel buffer */
+            tile.timeWidth = timeWidth;
+            tile.pixels.assign(spectrumWidth * timeWidth, 0);
+
+            /* Resize pixels texture */
+            if (tile.pixelsTexture)
+                SDL_DestroyTexture(tile.pixelsTexture);
+
+            tile.pixelsTexture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STATIC, static_cast<int>(spectrumWidth), static_cast<int>(timeWidth));
+            if (tile.pixelsTexture == nullptr)
+                throw SDLException("Creating SDL texture: SDL_CreateTexture(): " + std::string(SDL_GetError()));
+
+            SDL_UpdateTexture(tile.pixelsTexture, nullptr, tile.pixels.data(), static_cast<int>(spectrumWidth * sizeof(uint32_t)));
+        }
+
+        _renderLabel(tile);
+    }
+}
+
+void MosaicThread::_renderLabel(Tile &tile) {
+    SDL_Color labelColor = {0xff, 0xff, 0xff, 0xff};
+
+    std::string label = format("%s @ %u Hz, N %u, %s, Overlap %.0f%%", tile.label.c_str(), tile.sampleRate, tile.spectrogramThread.getDftSize(), to_string(tile.spectrogramThread.getDftWindowFunction()).c_str(), tile.spectrogramThread.getSamplesOverlap() * 100.0f);
+    label += format(", Mag. %.0f - %.0f", tile.spectrumRenderer.getMagnitudeMin(), tile.spectrumRenderer.getMagnitudeMax());
+
+    SDL_Surface *labelSurface = renderString(label, _font, labelColor);
+
+    if (tile.labelTexture)
+        SDL_DestroyTexture(tile.labelTexture);
+
+    tile.labelTexture = SDL_CreateTextureFromSurface(_renderer, labelSurface);
+    if (tile.labelTexture == nullptr)
+        throw SDLException("Creating SDL texture: SDL_CreateTextureFromSurface(): " + std::string(SDL_GetError()));
+
+    tile.labelRect = {tile.rect.x + 2, tile.rect.y + 2, labelSurface->w, labelSurface->h};
+
+    SDL_FreeSurface(labelSurface);
+}
+
+MosaicThread::Tile *MosaicThread::_getTile(int x, int y) {
+    SDL_Point point = {x, y};
+
+    for (std::unique_ptr<Tile> &tile : _tiles) {
+        if (SDL_PointInRect(&point, &tile->rect))
+            return tile.get();
+    }
+
+    return nullptr;
+}
+
+void MosaicThread::_handleKeyDown(const uint8_t *state) {
+    if (state[SDL_SCANCODE_Q]) {
+        _running = false;
+        return;
+    } else if (state[SDL_SCANCODE_S]) {
+        _hideLabels = !_hideLabels;
+        return;
+    } else if (state[SDL_SCANCODE_F]) {
+        _fullscreen = !_fullscreen;
+        if (_fullscreen) {
+            if (SDL_SetWindowFullscreen(_win, SDL_WINDOW_FULLSCREEN_DESKTOP) < 0)
+                throw SDLException("Setting fullscreen on SDL window: SDL_SetWindowFullscreen(): " + std::string(SDL_GetError()));
+        } else {
+            if (SDL_SetWindowFullscreen(_win, 0) < 0)
+                throw SDLException("Clearing fullscreen on SDL window: SDL_SetWindowFullscreen(): " + std::string(SDL_GetError()));
+        }
+        return;
+    }
+
+    /* Remaining controls apply to the tile under the mouse */
+    int mx, my;
+    SDL_GetMouseState(&mx, &my);
+    Tile *tile = _getTile(mx, my);
+    if (tile == nullptr)
+        return;
+
+    SpectrogramThread &spectrogramThread = tile->spectrogramThread;
+    SpectrumRenderer &spectrumRenderer = tile->spectrumRenderer;
+
+    if (state[SDL_SCANCODE_C]) {
+        /* Change color scheme */
+        SpectrumRenderer::ColorScheme next_colorScheme = SpectrumRenderer::ColorScheme::Heat;
+
+        if (spectrumRenderer.getColorScheme() == SpectrumRenderer::ColorScheme::Heat)
+            next_colorScheme = SpectrumRenderer::ColorScheme::Blue;
+        else if (spectrumRenderer.getColorScheme() == SpectrumRenderer::ColorScheme::Blue)
+            next_colorScheme = SpectrumRenderer::ColorScheme::Grayscale;
+
+        std::lock_guard<std::mutex> lg(tile->lock);
+        spectrumRenderer.setColorScheme(next_colorScheme);
+    } else if (state[SDL_SCANCODE_W]) {
+        /* Change window function */
+        RealDft::WindowFunction next_wf = RealDft::WindowFunction::Hann;
+
+        if (spectrogramThread.getDftWindowFunction() == RealDft::WindowFunction::Hann)
+            next_wf = RealDft::WindowFunction::Hamming;
+        else if (spectrogramThread.getDftWindowFunction() == RealDft::WindowFunction::Hamming)
+            next_wf = RealDft::WindowFunction::Bartlett;
+        else if (spectrogramThread.getDftWindowFunction() == RealDft::WindowFunction::Bartlett)
+            next_wf = RealDft::WindowFunction::Rectangular;
+
+        spectrogramThread.setDftWindowFunction(next_wf);
+    } else if (state[SDL_SCANCODE_L]) {
+        /* Toggle between Logarithimic/Linear */
+        bool next_magnitudeLog = !spectrumRenderer.getMagnitudeLog();
+
+        std::lock_guard<std::mutex> lg(tile->lock);
+        spectrumRenderer.setMagnitudeLog(next_magnitudeLog);
+        if (next_magnitudeLog) {
+            spectrumRenderer.setMagnitudeMin(InitialSettings.magnitudeLogMin);
+            spectrumRenderer.setMagnitudeMax(InitialSettings.magnitudeLogMax);
+        } else {
+            spectrumRenderer.setMagnitudeMin(InitialSettings.magnitudeLinearMin);
+            spectrumRenderer.setMagnitudeMax(InitialSettings.magnitudeLinearMax);
+        }
+    } else if (state[SDL_SCANCODE_RIGHT] || state[SDL_SCANCODE_LEFT]) {
+        /* DFT N up/down */
+        unsigned int dftSize = spectrogramThread.getDftSize();
+        unsigned int next_dftSize = state[SDL_SCANCODE_RIGHT] ? std::min<unsigned int>(dftSize * 2, UserLimits.dftSizeMax) : std::max<unsigned int>(dftSize / 2, UserLimits.dftSizeMin);
+
+        if (next_dftSize == dftSize)
+            return;
+
+        spectrogramThread.setDftSize(next_dftSize);
+
+        /* Reset samples overlap to 50% */
+        spectrogramThread.setSamplesOverlap(0.50);
+    } else if (state[SDL_SCANCODE_DOWN]) {
+        /* Samples Overlap Down */
+        spectrogramThread.setSamplesOverlap(std::max<float>(spectrogramThread.getSamplesOverlap() - UserLimits.samplesOverlapStep, UserLimits.samplesOverlapMin));
+    } else if (state[SDL_SCANCODE_UP]) {
+        /* Samples Overlap Up */
+        spectrogramThread.setSamplesOverlap(std::min<float>(spectrogramThread.getSamplesOverlap() + UserLimits.samplesOverlapStep, UserLimits.samplesOverlapMax));
+    } else if (state[SDL_SCANCODE_MINUS] || state[SDL_SCANCODE_EQUALS]) {
+        /* Magnitude min down/up */
+        float step = spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogStep : UserLimits.magnitudeLinearStep;
+        float lower = spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogMin : UserLimits.magnitudeLinearMin;
+        float next_magnitudeMin = state[SDL_SCANCODE_MINUS] ? std::max<float>(spectrumRenderer.getMagnitudeMin() - step, lower) : std::min<float>(spectrumRenderer.getMagnitudeMin() + step, spectrumRenderer.getMagnitudeMax() - step);
+
+        std::lock_guard<std::mutex> lg(tile->lock);
+        spectrumRenderer.setMagnitudeMin(next_magnitudeMin);
+    } else if (state[SDL_SCANCODE_LEFTBRACKET] || state[SDL_SCANCODE_RIGHTBRACKET]) {
+        /* Magnitude max down/up */
+        float step = spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogStep : UserLimits.magnitudeLinearStep;
+        float upper = spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogMax : UserLimits.magnitudeLinearMax;
+        float next_magnitudeMax = state[SDL_SCANCODE_RIGHTBRACKET] ? std::min<float>(spectrumRenderer.getMagnitudeMax() + step, upper) : std::max<float>(spectrumRenderer.getMagnitudeMax() - step, spectrumRenderer.getMagnitudeMin() + step);
+
+        std::lock_guard<std::mutex> lg(tile->lock);
+        spectrumRenderer.setMagnitudeMax(next_magnitudeMax);
+    } else {
+        return;
+    }
+
+    _renderLabel(*tile);
+}
+
+void MosaicThread::run() {
+    std::vector<uint32_t> newPixels;
+
+    for (std::unique_ptr<Tile> &tile : _tiles)
+        tile->audioThread.start();
+
+    _running = true;
+
+    while (_running) {
+        /* Handle SDL events */
+        SDL_Event e;
+        if (SDL_PollEvent(&e)) {
+            if (e.type == SDL_QUIT) {
+                _running = false;
+            } else if (e.type == SDL_KEYDOWN) {
+                const uint8_t *state = SDL_GetKeyboardState(nullptr);
+                _handleKeyDown(state);
+            } else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_RESIZED) {
+                _width = static_cast<unsigned int>(e.window.data1);
+                _height = static_cast<unsigned int>(e.window.data2);
+
+                _layoutTiles();
+            }
+        }
+
+        /* Rethrow worker exception */
+        {
+            std::lock_guard<std::mutex> lg(_exceptionLock);
+            if (_exception)
+                std::rethrow_exception(_exception);
+        }
+
+        SDL_RenderClear(_renderer);
+
+        for (std::unique_ptr<Tile> &tile : _tiles) {
+            /* Queue spectrum work for idle tiles with new samples */
+            if (!tile->busy && !tile->samplesQueue.empty())
+                _process(*tile);
+
+            /* Collect new colored rows */
+            {
+                std::lock_guard<std::mutex> lg(tile->lock);
+                newPixels.swap(tile->newPixels);
+            }
+
+            /* Update pixel buffer with new pixels */
+            if (newPixels.size() > 0) {
+                uint32_t *data = newPixels.data();
+                size_t size = newPixels.size();
+
+                if (size > tile->pixels.size()) {
+                    /* Pixel buffer overrun, use the last pixels */
+                    data = newPixels.data() + (size - tile->pixels.size());
+                    size = tile->pixels.size();
+                }
+
+                /* Move old pixels up */
+                memmove(tile->pixels.data(), tile->pixels.data() + size, (tile->pixels.size() - size) * sizeof(uint32_t));
+
+                /* Copy new pixels over */
+                memcpy(tile->pixels.data() + (tile->pixels.size() - size), data, size * sizeof(uint32_t));
+
+                newPixels.clear();
+
+                SDL_UpdateTexture(tile->pixelsTexture, nullptr, tile->pixels.data(), static_cast<int>(tile->spectrumWidth * sizeof(uint32_t)));
+            }
+
+            /* Render pixels */
+            if (_orientation == Orientation::Vertical) {
+                SDL_RenderCopy(_renderer, tile->pixelsTexture, nullptr, &tile->rect);
+            } else {
+                SDL_Rect destRect = {tile->rect.x + (tile->rect.w - tile->rect.h) / 2, tile->rect.y - (tile->rect.w - tile->rect.h) / 2, tile->rect.h, tile->rect.w};
+                SDL_RenderCopyEx(_renderer, tile->pixelsTexture, nullptr, &destRect, 90, nullptr, static_cast<SDL_RendererFlip>(SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL));
+            }
+
+            /* Render label */
+            if (!_hideLabels)
+                SDL_RenderCopy(_renderer, tile->labelTexture, nullptr, &tile->labelRect);
+        }
+
+        /* Outline tiles */
+        SDL_SetRenderDrawColor(_renderer, 0x40, 0x40, 0x40, 0xff);
+        for (std::unique_ptr<Tile> &tile : _tiles)
+            SDL_RenderDrawRect(_renderer, &tile->rect);
+        SDL_SetRenderDrawColor(_renderer, 0x00, 0x00, 0x00, 0xff);
+
+        SDL_RenderPresent(_renderer);
+
+        SDL_Delay(5);
+    }
+
+    for (std::unique_ptr<Tile> &tile : _tiles)
+        tile->audioThread.stop();
+
+    /* Finish worker tasks */
+    _threadPool.wait();
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "InterfaceHelpers.hpp"
+#include "ThreadSafeQueue.hpp"
+#include "ThreadPool.hpp"
+#include "AudioThread.hpp"
+#include "SpectrogramThread.hpp"
+#include "spectrogram/SpectrumRenderer.hpp"
+#include "Configuration.hpp"
+
+/*
+ * Tiled real-time spectrograms of several audio sources in one window.
+ *
+ * Each source has its own audio thread and settings, but spectrum computation
+ * and coloring of all sources run on one shared worker pool, and all tiles
+ * share one window, renderer and font. Keyboard controls apply to the tile
+ * under the mouse. Tiles do not keep scrollback history.
+ */
+class MosaicThread {
+  public:
+    MosaicThread(const Configuration::Settings &initialSettings);
+    ~MosaicThread();
+
+    void run();
+
+  private:
+    struct Tile {
+        Tile(const Configuration::Settings &settings, const Configuration::AudioSourceSettings &source);
+
+        /* Source description */
+        std::string label;
+        unsigned int sampleRate;
+
+        /* Audio and spectrum pipeline, the spectrogram is processed by the worker pool */
+        ThreadSafeQueue<std::vector<float>> samplesQueue;
+        ThreadSafeQueue<std::vector<uint16_t>> magnitudesQueue;
+        AudioThread audioThread;
+        SpectrogramThread spectrogramThread;
+
+        /* Renderer and new colored rows, guarded by lock */
+        Spectrogram::SpectrumRenderer spectrumRenderer;
+        std::vector<uint32_t> newPixels;
+        unsigned int spectrumWidth;
+        std::mutex lock;
+
+        /* Set while a worker task is queued or running for this tile */
+        std::atomic<bool> busy;
+
+        /* Colored pixels of visible rows, owned by the interface */
+        std::vector<uint32_t> pixels;
+        unsigned int timeWidth;
+
+        /* Owned resources (SDL) */
+        SDL_Texture *pixelsTexture = nullptr;
+        SDL_Texture *labelTexture = nullptr;
+        SDL_Rect rect;
+        SDL_Rect labelRect;
+    };
+
+    /* Submit worker task for a tile */
+    void _process(Tile &tile);
+
+    /* Helper functions for SDL */
+    void _layoutTiles();
+    void _handleKeyDown(const uint8_t *state);
+    void _renderLabel(Tile &tile);
+    Tile *_getTile(int x, int y);
+
+    /* Running boolean */
+    bool _running;
+
+    /* Tiles, one per audio source */
+    std::vector<std::unique_ptr<Tile>> _tiles;
+    unsigned int _columns, _rows;
+
+    /* Shared spectrum workers, and the first worker exception */
+    ThreadPool _threadPool;
+    std::exception_ptr _exception;
+    std::mutex _exceptionLock;
+
+    /* Owned resources (SDL) */
+    SDL_Window *_win = nullptr;
+    SDL_Renderer *_renderer = nullptr;
+    TTF_Font *_font = nullptr;
+
+    /* Interface settings */
+    bool _fullscreen;
+    unsigned int _width, _height;
+    const Configuration::Orientation _orientation;
+    bool _hideLabels = false;
+};
@@ -0,0 +1,203 @@
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "PyramidWriter.hpp"
+
+using namespace Image;
+using namespace Spectrogram;
+
+constexpr size_t PyramidWriter::TileSize;
+
+static void makeDirectory(const std::string &path) {
+    if (mkdir(path.c_str(), 0755) < 0)
+        throw PyramidWriteException("Error creating pyramid directory " + path + ": " + std::string(strerror(errno)));
+}
+
+PyramidWriter::PyramidWriter(std::string path, unsigned int spectrumWidth, float secondsPerRow, MagickImageSink::Orientation orientation, SpectrumRenderer &spectrumRenderer) : _path(path), _spectrumWidth(spectrumWidth), _secondsPerRow(secondsPerRow), _orientation(orientation), _spectrumRenderer(spectrumRenderer), _threadPool(ThreadPool::defaultThreads()) {
+    /* Accept the descriptor path or the name it is derived from */
+    if (_path.size() > 4 && _path.compare(_path.size() - 4, 4, ".dzi") == 0)
+        _path.resize(_path.size() - 4);
+
+    /* Levels are renamed into place at the end, so stale levels from an earlier pyramid would be in the way */
+    _filesPath = _path + "_files";
+    struct stat st;
+    if (stat(_filesPath.c_str(), &st) == 0)
+        throw PyramidWriteException("Pyramid tile directory already exists: " + _filesPath);
+
+    makeDirectory(_filesPath);
+}
+
+std::string PyramidWriter::_getDepthPath(size_t depth) {
+    return _filesPath + "/depth" + std::to_string(depth);
+}
+
+void PyramidWriter::append(const std::vector<uint16_t> &magnitudes) {
+    if (magnitudes.size() != _spectrumWidth)
+        throw PyramidWriteException("Magnitudes size does not match pyramid width!");
+
+    _append(0, magnitudes.data());
+}
+
+void PyramidWriter::_append(size_t depth, const uint16_t *magnitudes) {
+    /* Create level on first row, at half the spectrum width of the level above */
+    if (depth == _levels.size()) {
+        makeDirectory(_getDepthPath(depth));
+
+        _levels.emplace_back();
+        Level &l = _levels[depth];
+        l.width = (depth == 0) ? _spectrumWidth : (_levels[depth - 1].width + 1) / 2;
+        l.tile.resize(TileSize * l.width);
+        l.pooled.resize((l.width + 1) / 2);
+    }
+
+    Level &l = _levels[depth];
+
+    /* Flush full tile row, pooling it into the next level */
+    if (l.tileRows == TileSize)
+        _flushTile(depth, true);
+
+    memcpy(l.tile.data() + l.tileRows * l.width, magnitudes, sizeof(uint16_t) * l.width);
+    l.tileRows++;
+    l.rows++;
+}
+
+void PyramidWriter::_pool(size_t depth, const uint16_t *a, const uint16_t *b) {
+    Level &l = _levels[depth];
+
+    /* Pair bins from the top of the image, which is the highest bin in horizontal orientation */
+    size_t shift = (_orientation == MagickImageSink::Orientation::Horizontal) ? (l.width % 2) : 0;
+
+    for (size_t j = 0; j < l.pooled.size(); j++) {
+        size_t lo = (2 * j >= shift) ? (2 * j - shift) : 0;
+        size_t hi = std::min(2 * j + 1 - shift, l.width - 1);
+        l.pooled[j] = std::max(std::max(a[lo], a[hi]), std::max(b[lo], b[hi]));
+    }
+
+    _append(depth + 1, l.pooled.data());
+}
+
+void PyramidWriter::_flushTile(size_t depth, bool pool) {
+    Level &l = _levels[depth];
+
+    /* Max-pool 2x2 blocks into the next level */
+    if (pool) {
+        for (size_t i = 0; i < l.tileRows; i += 2) {
+            const uint16_t *a = l.tile.data() + i * l.width;
+            const uint16_t *b = (i + 1 < l.tileRows) ? (a + l.width) : a;
+            _pool(depth, a, b);
+        }
+    }
+
+    /* Hand tile row off for encoding, one tile per TileSize bins */
+    std::shared_ptr<std::vector<uint16_t>> magnitudes = std::make_shared<std::vector<uint16_t>>(TileSize * l.width);
+    magnitudes->swap(l.tile);
+
+    size_t spectrumTiles = (l.width + TileSize - 1) / TileSize;
+    for (size_t s = 0; s < spectrumTiles; s++) {
+        /* Spectrum tiles run left to right in vertical orientation, and top (highest bins) to bottom in horizontal orientation */
+        size_t column, row, binStart, binEnd;
+        if (_orientation == MagickImageSink::Orientation::Vertical) {
+            column = s;
+            row = l.tiles;
+            binStart = s * TileSize;
+            binEnd = std::min(binStart + TileSize, l.width);
+        } else {
+            column = l.tiles;
+            row = s;
+            binEnd = l.width - s * TileSize;
+            binStart = (binEnd > TileSize) ? (binEnd - TileSize) : 0;
+        }
+
+        std::string path = _getDepthPath(depth) + "/" + std::to_string(column) + "_" + std::to_string(row) + ".png";
+        _encodeTile(path, magnitudes, l.width, l.tileRows, binStart, binEnd - binStart);
+    }
+
+    l.tiles++;
+    l.tileRows = 0;
+}
+
+void PyramidWriter::_encodeTile(std::string path, std::shared_ptr<std::vector<uint16_t>> magnitudes, size_t width, size_t rows, size_t binStart, size_t binCount) {
+    /* Wait for room in the encoding backlog */
+    {
+        std::unique_lock<std::mutex> lg(_pendingLock);
+        while (_pendingTiles >= 2 * _threadPool.getThreads())
+            _cvPending.wait(lg);
+        _pendingTiles++;
+    }
+
+    _threadPool.submit([this, magnitudes, path, width, rows, binStart, binCount](unsigned int) {
+        try {
+            MagickImageSink image(path, static_cast<unsigned int>(binCount), _orientation);
+            std::vector<uint32_t> pixels(binCount);
+
+            for (size_t i = 0; i < rows; i++) {
+                _spectrumRenderer.render(pixels.data(), magnitudes->data() + i * width + binStart, binCount);
+                image.append(pixels);
+            }
+
+            image.write();
+        } catch (...) {
+            std::lock_guard<std::mutex> lg(_pendingLock);
+            _pendingTiles--;
+            _cvPending.notify_one();
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lg(_pendingLock);
+        _pendingTiles--;
+        _cvPending.notify_one();
+    });
+}
+
+void PyramidWriter::write() {
+    /* Flush partial tiles from the finest level down, pooling until a level is a single pixel */
+    for (size_t depth = 0; depth < _levels.size(); depth++) {
+        if (_levels[depth].tileRows > 0)
+            _flushTile(depth, _levels[depth].rows > 1 || _levels[depth].width > 1);
+    }
+
+    _threadPool.wait();
+
+    /* Rename levels to DZI level numbers, coarsest first */
+    for (size_t depth = 0; depth < _levels.size(); depth++) {
+        std::string levelPath = _filesPath + "/" + std::to_string(_levels.size() - 1 - depth);
+        if (rename(_getDepthPath(depth).c_str(), levelPath.c_str()) < 0)
+            throw PyramidWriteException("Error renaming pyramid level " + levelPath + ": " + std::string(strerror(errno)));
+    }
+
+    size_t rows = _levels.empty() ? 0 : _levels[0].rows;
+    size_t width = (_orientation == MagickImageSink::Orientation::Vertical) ? _spectrumWidth : rows;
+    size_t height = (_orientation == MagickImageSink::Orientation::Vertical) ? rows : _spectrumWidth;
+
+    /* Write DZI descriptor */
+    std::ofstream descriptor(_path + ".dzi", std::ios::trunc);
+    if (!descriptor)
+        throw PyramidWriteException("Error opening pyramid descriptor: " + _path + ".dzi");
+
+    descriptor << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    descriptor << "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" Format=\"png\" Overlap=\"0\" TileSize=\"" << TileSize << "\">\n";
+    descriptor << "  <Size Width=\"" << width << "\" Height=\"" << height << "\"/>\n";
+    descriptor << "</Image>\n";
+
+    if (!descriptor)
+        throw PyramidWriteException("Error writing pyramid descriptor.");
+
+    /* Write time resolution of the finest level */
+    std::ofstream index(_path + ".txt", std::ios::trunc);
+    if (!index)
+        throw PyramidWriteException("Error opening pyramid index: " + _path + ".txt");
+
+    index << "orientation " << ((_orientation == MagickImageSink::Orientation::Vertical) ? "vertical" : "horizontal") << "\n";
+    index << "spectrum_width " << _spectrumWidth << "\n";
+    index << "rows " << rows << "\n";
+    index << "seconds_per_row " << _secondsPerRow << "\n";
+
+    if (!index)
+        throw PyramidWriteException("Error writing pyramid index.");
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+#include "ThreadPool.hpp"
+#include "image/MagickImageSink.hpp"
+#include "spectrogram/SpectrumRenderer.hpp"
+
+/*
+ * Multi-resolution spectrogram pyramid of image tiles, in the Deep Zoom (DZI)
+ * layout read by OpenSeadragon and other tiled image viewers.
+ *
+ * The finest level holds the spectrogram at full resolution. Each coarser
+ * level halves both the time and frequency resolution by max-pooling 2x2
+ * blocks of quantized magnitudes, down to a single pixel. Square tiles of
+ * TileSize pixels are written as <name>_files/<level>/<column>_<row>.png,
+ * with level 0 the coarsest, and the image size and tiling are described in
+ * <name>.dzi. The time resolution of the finest level is written to
+ * <name>.txt, as DZI has no place for it.
+ *
+ * Rows are streamed through the levels as they arrive, before the number of
+ * levels is known, so each level is written under a depth from the finest
+ * level and renamed to its DZI level number in write().
+ */
+class PyramidWriter {
+  public:
+    /* Tile width and height in pixels */
+    static constexpr size_t TileSize = 256;
+
+    PyramidWriter(std::string path, unsigned int spectrumWidth, float secondsPerRow, Image::MagickImageSink::Orientation orientation, Spectrogram::SpectrumRenderer &spectrumRenderer);
+
+    /* Append a row of quantized magnitudes (spectrum width) */
+    void append(const std::vector<uint16_t> &magnitudes);
+
+    /* Flush partial tiles, wait for encoding, and write the DZI descriptor */
+    void write();
+
+  private:
+    struct Level {
+        /* Spectrum width of this level */
+        size_t width = 0;
+        /* Rows of the tile row being filled */
+        std::vector<uint16_t> tile;
+        size_t tileRows = 0;
+        /* Tile rows and rows emitted */
+        size_t tiles = 0;
+        size_t rows = 0;
+        /* Scratch pooled row for next level */
+        std::vector<uint16_t> pooled;
+    };
+
+    void _append(size_t depth, const uint16_t *magnitudes);
+    void _pool(size_t depth, const uint16_t *a, const uint16_t *b);
+    void _flushTile(size_t depth, bool pool);
+    void _encodeTile(std::string path, std::shared_ptr<std::vector<uint16_t>> magnitudes, size_t width, size_t rows, size_t binStart, size_t binCount);
+    std::string _getDepthPath(size_t depth);
+
+    /* Path without the .dzi extension, and tile directory */
+    std::string _path;
+    std::string _filesPath;
+    const unsigned int _spectrumWidth;
+    const float _secondsPerRow;
+    const Image::MagickImageSink::Orientation _orientation;
+    Spectrogram::SpectrumRenderer &_spectrumRenderer;
+
+    /* Levels by depth from the finest, deque so references survive growth while pooling */
+    std::deque<Level> _levels;
+
+    /* Bound on tiles waiting to be encoded */
+    size_t _pendingTiles = 0;
+    std::mutex _pendingLock;
+    std::condition_variable _cvPending;
+
+    ThreadPool _threadPool;
+};
+
+class PyramidWriteException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
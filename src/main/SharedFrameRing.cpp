@@ -0,0 +1,107 @@
+#include <cstring>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "spectrogram/SpectrumRenderer.hpp"
+
+#include "SharedFrameRing.hpp"
+
+constexpr size_t SharedFrameRing::SlotCapacity;
+
+SharedFrameRing::SharedFrameRing(std::string name, unsigned int slots, unsigned int sampleRate, bool replace) : _name((name.size() > 0 && name[0] == '/') ? name : "/" + name), _slots(slots), _size(sizeof(Header) + slots * sizeof(Slot)), _resampled(SlotCapacity) {
+    /* Create exclusively, so a ring still in use by another instance is never reset under its readers */
+    if (replace)
+        shm_unlink(_name.c_str());
+
+    _fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (_fd < 0 && errno == EEXIST)
+        throw SharedFrameRingException("Shared memory " + _name + " already exists, in use by another instance or left behind by one that crashed. Use a different name, or replace it with --shm-replace.");
+    if (_fd < 0)
+        throw SharedFrameRingException("Error creating shared memory " + _name + ": " + std::string(strerror(errno)));
+
+    if (ftruncate(_fd, static_cast<off_t>(_size)) < 0) {
+        int error = errno;
+        close(_fd);
+        shm_unlink(_name.c_str());
+        throw SharedFrameRingException("Error sizing shared memory " + _name + ": " + std::string(strerror(error)));
+    }
+
+    void *base = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (base == MAP_FAILED) {
+        int error = errno;
+        close(_fd);
+        shm_unlink(_name.c_str());
+        throw SharedFrameRingException("Error mapping shared memory " + _name + ": " + std::string(strerror(error)));
+    }
+
+    /* New memory is zeroed by ftruncate(), so all sequences start at 0 */
+    _header = static_cast<Header *>(base);
+    _slotsBase = reinterpret_cast<Slot *>(static_cast<char *>(base) + sizeof(Header));
+
+    memcpy(_header->magic, "APMRING", sizeof(_header->magic));
+    _header->version = 1;
+    _header->headerSize = sizeof(Header);
+    _header->slots = _slots;
+    _header->slotSize = sizeof(Slot);
+    _header->slotCapacity = static_cast<uint32_t>(SlotCapacity);
+    _header->sampleRate = sampleRate;
+    _header->quantizedMagnitudeMin = Spectrogram::SpectrumRenderer::QuantizedMagnitudeMin;
+    _header->quantizedMagnitudeMax = Spectrogram::SpectrumRenderer::QuantizedMagnitudeMax;
+    _header->sequence.store(0, std::memory_order_release);
+}
+
+static void storePairs(std::atomic<uint32_t> *words, const uint16_t *magnitudes, size_t count) {
+    /* Pack pairs in native order, as they would lie in a uint16 array */
+    for (size_t i = 0; i + 1 < count; i += 2) {
+        uint32_t word;
+        memcpy(&word, magnitudes + i, sizeof(word));
+        words[i / 2].store(word, std::memory_order_relaxed);
+    }
+
+    if (count % 2 != 0) {
+        uint16_t pair[2] = {magnitudes[count - 1], 0};
+        uint32_t word;
+        memcpy(&word, pair, sizeof(word));
+        words[count / 2].store(word, std::memory_order_relaxed);
+    }
+}
+
+SharedFrameRing::~SharedFrameRing() {
+    munmap(_header, _size);
+    close(_fd);
+    shm_unlink(_name.c_str());
+}
+
+void SharedFrameRing::publish(const std::vector<uint16_t> &magnitudes, const FrameInfo &info) {
+    uint64_t sequence = ++_sequence;
+    Slot &slot = _slotsBase[sequence % _slots];
+
+    /* Invalidate slot before overwriting it */
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint16_t *row = magnitudes.data();
+    size_t width = magnitudes.size();
+    if (width > SlotCapacity) {
+        Spectrogram::SpectrumRenderer::resample(_resampled, row, width);
+        row = _resampled.data();
+        width = SlotCapacity;
+    }
+
+    slot.width.store(static_cast<uint32_t>(width), std::memory_order_relaxed);
+    slot.dftSize.store(info.dftSize, std::memory_order_relaxed);
+    slot.samplesOverlap.store(info.samplesOverlap, std::memory_order_relaxed);
+    slot.engine.store(info.engine, std::memory_order_relaxed);
+    slot.frequencyScale.store(info.frequencyScale, std::memory_order_relaxed);
+    slot.zoomDecimation.store(info.zoomDecimation, std::memory_order_relaxed);
+    slot.zoomFrequency.store(info.zoomFrequency, std::memory_order_relaxed);
+    storePairs(slot.magnitudes, row, width);
+
+    /* Publish frame */
+    slot.sequence.store(sequence, std::memory_order_release);
+    _header->sequence.store(sequence, std::memory_order_release);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <cstdint>
+
+/*
+ * Ring of quantized magnitude rows in POSIX shared memory, for local readers.
+ *
+ * Layout (native byte order, little-endian on supported hosts)
+ *
+ *  Header (64 bytes)
+ *      char[8]         magic "APMRING\0"
+ *      uint32          version (1)
+ *      uint32          header size in bytes (64)
+ *      uint32          slot count
+ *      uint32          slot size in bytes, slots follow the header
+ *      uint32          slot capacity in magnitudes (SlotCapacity)
+ *      uint32          audio sample rate in Hz
+ *      float32         quantized magnitude minimum in dB
+ *      float32         quantized magnitude maximum in dB
+ *      uint64          sequence of the latest published frame, 0 for none
+ *      uint8[16]       reserved
+ *
+ *  Slot (slot size bytes), frame with sequence n is in slot n % slot count
+ *      uint64          sequence of the frame, 0 while it is being written
+ *      uint32          width in magnitudes
+ *      uint32          DFT size
+ *      uint32          samples overlap
+ *      uint32          spectrum engine (0 dft, 1 cqt, 2 sdft, 3 goertzel, 4 multitaper, 5 pfb)
+ *      uint32          frequency scale (0 linear, 1 logarithmic, 2 mel)
+ *      uint32          zoom decimation, 1 for no zoom
+ *      float32         zoom center frequency in Hz
+ *      uint8[28]       reserved
+ *      uint16[capacity] quantized magnitudes, the first width valid, linear in
+ *                      dB between minimum and maximum
+ *
+ * The header fields are written once, before the header sequence first
+ * becomes nonzero. The producer never waits on readers.
+ *
+ * Each slot is a sequence lock. The producer stores 0 to the slot sequence,
+ * issues a release fence, stores the slot fields and magnitudes with relaxed
+ * atomic stores, then stores the frame sequence to the slot with release
+ * ordering, and to the header with release ordering.
+ *
+ * A reader loads the header sequence with acquire ordering for the latest
+ * frame n, then for each frame it wants:
+ *
+ *      s1 = slot sequence (acquire load)
+ *      if s1 != n: the frame is not yet published, or was overwritten
+ *      copy the slot fields and magnitudes out of the slot
+ *      acquire fence
+ *      s2 = slot sequence (relaxed load)
+ *      if s2 != n: the copy may be torn, the reader has fallen behind
+ *
+ * The copy must be used only once s2 confirms it, and not read in place.
+ * The ring is created exclusively, so a name left behind by a crashed or
+ * running instance is an error, unless it is replaced on request.
+ */
+class SharedFrameRing {
+  public:
+    /* Magnitudes per slot, wider rows are resampled down */
+    static constexpr size_t SlotCapacity = 8192;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t slots;
+        uint32_t slotSize;
+        uint32_t slotCapacity;
+        uint32_t sampleRate;
+        float quantizedMagnitudeMin;
+        float quantizedMagnitudeMax;
+        std::atomic<uint64_t> sequence;
+        uint8_t reserved[16];
+    };
+
+    /* Slot fields and magnitudes are atomic, written with relaxed stores, so readers copying them concurrently do not race */
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint32_t> width;
+        std::atomic<uint32_t> dftSize;
+        std::atomic<uint32_t> samplesOverlap;
+        std::atomic<uint32_t> engine;
+        std::atomic<uint32_t> frequencyScale;
+        std::atomic<uint32_t> zoomDecimation;
+        std::atomic<float> zoomFrequency;
+        uint8_t reserved[28];
+        /* Pairs of quantized magnitudes, in native uint16 order */
+        std::atomic<uint32_t> magnitudes[SlotCapacity / 2];
+    };
+
+    /* Frame description, stored with each frame */
+    struct FrameInfo {
+        unsigned int dftSize;
+        unsigned int samplesOverlap;
+        unsigned int engine;
+        unsigned int frequencyScale;
+        unsigned int zoomDecimation;
+        float zoomFrequency;
+    };
+
+    /* Create the ring, replacing one of the same name if replace is set, otherwise failing if it exists */
+    SharedFrameRing(std::string name, unsigned int slots, unsigned int sampleRate, bool replace);
+    ~SharedFrameRing();
+
+    SharedFrameRing(const SharedFrameRing &) = delete;
+    SharedFrameRing &operator=(const SharedFrameRing &) = delete;
+
+    /* Publish a row of quantized magnitudes as the next frame */
+    void publish(const std::vector<uint16_t> &magnitudes, const FrameInfo &info);
+
+  private:
+    std::string _name;
+    unsigned int _slots;
+    size_t _size;
+    int _fd;
+    Header *_header;
+    Slot *_slotsBase;
+    uint64_t _sequence = 0;
+
+    /* Resampled row, for rows wider than the slot capacity */
+    std::vector<uint16_t> _resampled;
+};
+
+static_assert(sizeof(SharedFrameRing::Header) == 64, "Unexpected shared frame ring header size.");
+static_assert(sizeof(SharedFrameRing::Slot) % 64 == 0, "Unexpected shared frame ring slot size.");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "Shared frame ring requires lock-free 32-bit and 64-bit atomics.");
+static_assert(sizeof(std::atomic<uint32_t>) == 4 && sizeof(std::atomic<float>) == 4, "Unexpected shared frame ring atomic size.");
+
+class SharedFrameRingException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Lock-free single producer, single consumer snapshot of a value (triple
+ * buffer). The producer publishes whole copies of the value and never waits on
+ * the consumer. The consumer picks up the latest published copy when it polls,
+ * and reads it without locking until its next poll.
+ */
+template <typename T>
+class SnapshotBuffer {
+  public:
+    SnapshotBuffer(const T &value);
+
+    /* Publish a new value (producer) */
+    void publish(const T &value);
+
+    /* Pick up the latest published value, returns true if it changed (consumer) */
+    bool update();
+
+    /* Get the current value (consumer) */
+    const T &get();
+
+  private:
+    /* Middle slot index, with dirty flag set when it holds an unread publish */
+    static constexpr uint8_t Dirty = 0x4;
+
+    T _slots[3];
+    uint8_t _back = 0;
+    std::atomic<uint8_t> _middle;
+    uint8_t _front = 2;
+};
+
+template <typename T>
+SnapshotBuffer<T>::SnapshotBuffer(const T &value) : _slots{value, value, value}, _middle(1) {
+}
+
+template <typename T>
+void SnapshotBuffer<T>::publish(const T &value) {
+    _slots[_back] = value;
+    _back = _middle.exchange(static_cast<uint8_t>(_back | Dirty), std::memory_order_acq_rel) & static_cast<uint8_t>(~Dirty);
+}
+
+template <typename T>
+bool SnapshotBuffer<T>::update() {
+    if ((_middle.load(std::memory_order_relaxed) & Dirty) == 0)
+        return false;
+
+    _front = _middle.exchange(_front, std::memory_order_acq_rel) & static_cast<uint8_t>(~Dirty);
+    return true;
+}
+
+template <typename T>
+const T &SnapshotBuffer<T>::get() {
+    return _slots[_front];
+}
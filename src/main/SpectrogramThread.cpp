@@ -1,13 +1,43 @@
 #include <cstring>
 #include <complex>
+#include <algorithm>
 #include <unistd.h>
 
 #include "SpectrogramThread.hpp"
 
-SpectrogramThread::SpectrogramThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, ThreadSafeQueue<std::vector<uint32_t>> &pixelsQueue, const Configuration::Settings &initialSettings) : _samplesQueue(samplesQueue), _pixelsQueue(pixelsQueue), _realDft(initialSettings.dftSize, initialSettings.dftWindowFunction), _spectrumRenderer(initialSettings.magnitudeMin, initialSettings.magnitudeMax, initialSettings.magnitudeLog, initialSettings.colorScheme) {
-    _samplesOverlap = static_cast<unsigned int>(initialSettings.samplesOverlap * static_cast<float>(initialSettings.dftSize));
-    _pixelLine.resize((initialSettings.orientation == Configuration::Orientation::Vertical) ? initialSettings.width : initialSettings.height);
+SpectrogramThread::SpectrogramThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, ThreadSafeQueue<std::vector<uint16_t>> &magnitudesQueue, const Configuration::Settings &initialSettings) : _samplesQueue(samplesQueue), _magnitudesQueue(magnitudesQueue), _settings{(initialSettings.orientation == Configuration::Orientation::Vertical) ? initialSettings.width : initialSettings.height, initialSettings.dftSize, initialSettings.dftWindowFunction, static_cast<unsigned int>(initialSettings.samplesOverlap * static_cast<float>(initialSettings.dftSize)), initialSettings.dftEngine, initialSettings.cqtBinsPerOctave, initialSettings.cqtMinFrequency, initialSettings.multitaperTapers, initialSettings.pfbTaps, initialSettings.averageMode, initialSettings.averageAlpha, initialSettings.averageFrames, initialSettings.zoomFrequency, initialSettings.zoomDecimation, initialSettings.frequencyScale}, _settingsSnapshot(_settings), _appliedSettings(_settings), _realDft(_settings.dftSize, _settings.dftWindowFunction), _sampleRate(initialSettings.audioSampleRate), _goertzelFrequencies(initialSettings.goertzelFrequencies), _frequencyAxis(_settings.frequencyScale), _spectrumAverager(_settings.averageMode, _settings.averageAlpha, _settings.averageFrames), _zoomFilter(initialSettings.audioSampleRate, _settings.zoomFrequency, _settings.zoomDecimation) {
+    _samplesOverlap = _settings.samplesOverlap;
+    _magnitudeLine.resize(_settings.width);
+    _engine = _settings.engine;
+    if (_engine == DFT::SpectrumEngine::Type::ConstantQ)
+        _constantQ.reset(new DFT::ConstantQTransform(_settings.dftSize, _settings.dftWindowFunction, _sampleRate, _settings.cqtBinsPerOctave, _settings.cqtMinFrequency));
+    if (_engine == DFT::SpectrumEngine::Type::SlidingDft) {
+        _slidingDft.reset(new DFT::SlidingDft(_settings.dftSize, _settings.dftWindowFunction));
+        _slidingDft->setHop(_settings.dftSize - _settings.samplesOverlap);
+    }
+    if (_engine == DFT::SpectrumEngine::Type::Goertzel)
+        _goertzelBank.reset(new DFT::GoertzelBank(_settings.dftSize, _settings.dftWindowFunction, _sampleRate, _goertzelFrequencies));
+    if (_engine == DFT::SpectrumEngine::Type::Multitaper)
+        _multitaperDft.reset(new DFT::MultitaperDft(_settings.dftSize, _settings.multitaperTapers));
+    if (_engine == DFT::SpectrumEngine::Type::Polyphase) {
+        _polyphaseFilterbank.reset(new DFT::PolyphaseFilterbank(_settings.dftSize, _settings.dftWindowFunction, _settings.pfbTaps));
+        _polyphaseFilterbank->setHop(_settings.dftSize - _settings.samplesOverlap);
+    }
+    _zoomDecimation = _settings.zoomDecimation;
+    if (_zoomDecimation > 1)
+        _complexDft.reset(new DFT::ComplexDft(_settings.dftSize, _settings.dftWindowFunction));
     _samplesQueueCount = 0;
+
+    /* Frame workers, each with its own engine, created on first use */
+    unsigned int threads = (initialSettings.dftThreads == 0) ? ThreadPool::defaultThreads() : initialSettings.dftThreads;
+    if (threads > 1) {
+        _threadPool.reset(new ThreadPool(threads));
+        _frameWorkers.resize(threads);
+    }
+
+    /* Shared frame ring for local readers */
+    if (initialSettings.frameRingName != "")
+        _frameRing.reset(new SharedFrameRing(initialSettings.frameRingName, initialSettings.frameRingSlots, _sampleRate, initialSettings.frameRingReplace));
 }
 
 void SpectrogramThread::start() {
@@ -20,147 +50,429 @@ void SpectrogramThread::stop() {
     _thread.join();
 }
 
-void SpectrogramThread::_run() {
-    /* Audio Samples Buffer */
-    std::vector<float> audioSamples;
-    /* Overlapped Samples */
-    std::vector<float> overlapSamples;
-    /* DFT of Overlapped Samples */
-    std::vector<std::complex<float>> dftSamples;
+/* Advance overlap window by one hop of new samples, returns false if more samples are needed */
+template <typename T>
+static bool shiftSamples(std::vector<T> &overlapSamples, std::vector<T> &samples, unsigned int samplesOverlap) {
+    size_t samplesHop = overlapSamples.size() - samplesOverlap;
 
-    while (_running) {
-        std::vector<float> newAudioSamples;
+    /* If we don't have enough samples to update overlap window, continue to pop more */
+    if (samples.size() < samplesHop)
+        return false;
+
+    /* Move down samplesOverlap length old samples */
+    memmove(overlapSamples.data(), overlapSamples.data() + samplesHop, sizeof(T) * samplesOverlap);
+    /* Copy samplesHop length new samples */
+    memcpy(overlapSamples.data() + samplesOverlap, samples.data(), sizeof(T) * samplesHop);
+    /* Erase used samples */
+    samples.erase(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(samplesHop));
+
+    return true;
+}
 
+void SpectrogramThread::_run() {
+    while (_running) {
         /* Poll with timeout, in case this thread is asked to stop */
         if (!_samplesQueue.wait(std::chrono::milliseconds(100)))
             continue;
 
+        process();
+    }
+}
+
+void SpectrogramThread::process() {
+    while (!_samplesQueue.empty()) {
         /* Pop new audio samples */
-        newAudioSamples = _samplesQueue.pop();
+        std::vector<float> newAudioSamples = _samplesQueue.pop();
 
         /* Track samples queue count for debug statistics */
         _samplesQueueCount = _samplesQueue.count();
 
-        /* Add new audio samples to our audio samples buffer */
-        audioSamples.insert(audioSamples.end(), newAudioSamples.begin(), newAudioSamples.end());
+        /* Pick up new settings at frame boundary */
+        if (_settingsSnapshot.update()) {
+            const DftSettings &settings = _settingsSnapshot.get();
+
+            /* Compute frames batched under the old settings */
+            _flushFrames();
+
+            /* Restart averaging on a change of spectrum */
+            if (_engine != settings.engine || _zoomDecimation != settings.zoomDecimation || _zoomFilter.getCenterFrequency() != settings.zoomFrequency || _realDft.getWindowFunction() != settings.dftWindowFunction)
+                _spectrumAverager.reset();
+
+            if (_realDft.getSize() != settings.dftSize)
+                _realDft.setSize(settings.dftSize);
+            if (_realDft.getWindowFunction() != settings.dftWindowFunction)
+                _realDft.setWindowFunction(settings.dftWindowFunction);
+
+            if (settings.zoomDecimation > 1) {
+                if (!_complexDft)
+                    _complexDft.reset(new DFT::ComplexDft(settings.dftSize, settings.dftWindowFunction));
+                if (_complexDft->getSize() != settings.dftSize)
+                    _complexDft->setSize(settings.dftSize);
+                if (_complexDft->getWindowFunction() != settings.dftWindowFunction)
+                    _complexDft->setWindowFunction(settings.dftWindowFunction);
+
+                /* Restart baseband samples on enabling zoom, or on a new decimation or center frequency */
+                if (_zoomDecimation <= 1 || _zoomFilter.getDecimation() != settings.zoomDecimation || _zoomFilter.getCenterFrequency() != settings.zoomFrequency) {
+                    _zoomFilter.setCenterFrequency(settings.zoomFrequency);
+                    _zoomFilter.setDecimation(settings.zoomDecimation);
+                    _zoomFilter.reset();
+                    _basebandSamples.clear();
+                    _overlapBasebandSamples.clear();
+                }
+            }
+
+            if (settings.engine == DFT::SpectrumEngine::Type::ConstantQ) {
+                /* Kernels are rebuilt only when their configuration changes */
+                if (!_constantQ)
+                    _constantQ.reset(new DFT::ConstantQTransform(settings.dftSize, settings.dftWindowFunction, _sampleRate, settings.cqtBinsPerOctave, settings.cqtMinFrequency));
+                if (_constantQ->getSize() != settings.dftSize)
+                    _constantQ->setSize(settings.dftSize);
+                if (_constantQ->getWindowFunction() != settings.dftWindowFunction)
+                    _constantQ->setWindowFunction(settings.dftWindowFunction);
+                if (_constantQ->getBinsPerOctave() != settings.cqtBinsPerOctave)
+                    _constantQ->setBinsPerOctave(settings.cqtBinsPerOctave);
+            } else if (settings.engine == DFT::SpectrumEngine::Type::SlidingDft) {
+                if (!_slidingDft)
+                    _slidingDft.reset(new DFT::SlidingDft(settings.dftSize, settings.dftWindowFunction));
+                if (_slidingDft->getSize() != settings.dftSize)
+                    _slidingDft->setSize(settings.dftSize);
+                if (_slidingDft->getWindowFunction() != settings.dftWindowFunction)
+                    _slidingDft->setWindowFunction(settings.dftWindowFunction);
+                _slidingDft->setHop(settings.dftSize - settings.samplesOverlap);
+            } else if (settings.engine == DFT::SpectrumEngine::Type::Goertzel) {
+                if (!_goertzelBank)
+                    _goertzelBank.reset(new DFT::GoertzelBank(settings.dftSize, settings.dftWindowFunction, _sampleRate, _goertzelFrequencies));
+                if (_goertzelBank->getSize() != settings.dftSize)
+                    _goertzelBank->setSize(settings.dftSize);
+                if (_goertzelBank->getWindowFunction() != settings.dftWindowFunction)
+                    _goertzelBank->setWindowFunction(settings.dftWindowFunction);
+            } else if (settings.engine == DFT::SpectrumEngine::Type::Multitaper) {
+                /* Tapers are recomputed only when the size or number of tapers changes */
+                if (!_multitaperDft)
+                    _multitaperDft.reset(new DFT::MultitaperDft(settings.dftSize, settings.multitaperTapers));
+                if (_multitaperDft->getSize() != settings.dftSize)
+                    _multitaperDft->setSize(settings.dftSize);
+                if (_multitaperDft->getTapers() != settings.multitaperTapers)
+                    _multitaperDft->setTapers(settings.multitaperTapers);
+            } else if (settings.engine == DFT::SpectrumEngine::Type::Polyphase) {
+                /* Prototype filter is rebuilt only when the size, window, or taps change */
+                if (!_polyphaseFilterbank)
+                    _polyphaseFilterbank.reset(new DFT::PolyphaseFilterbank(settings.dftSize, settings.dftWindowFunction, settings.pfbTaps));
+                if (_polyphaseFilterbank->getSize() != settings.dftSize)
+                    _polyphaseFilterbank->setSize(settings.dftSize);
+                if (_polyphaseFilterbank->getWindowFunction() != settings.dftWindowFunction)
+                    _polyphaseFilterbank->setWindowFunction(settings.dftWindowFunction);
+                if (_polyphaseFilterbank->getTaps() != settings.pfbTaps)
+                    _polyphaseFilterbank->setTaps(settings.pfbTaps);
+                _polyphaseFilterbank->setHop(settings.dftSize - settings.samplesOverlap);
+            }
 
-        {
-            /* Lock DFT */
-            std::lock_guard<std::mutex> dftLg(_realDftLock);
+            if (_frequencyAxis.getScale() != settings.frequencyScale)
+                _frequencyAxis.setScale(settings.frequencyScale);
+
+            if (_spectrumAverager.getMode() != settings.averageMode)
+                _spectrumAverager.setMode(settings.averageMode);
+            if (_spectrumAverager.getAlpha() != settings.averageAlpha)
+                _spectrumAverager.setAlpha(settings.averageAlpha);
+            if (_spectrumAverager.getFrames() != settings.averageFrames)
+                _spectrumAverager.setFrames(settings.averageFrames);
+
+            _samplesOverlap = settings.samplesOverlap;
+            _engine = settings.engine;
+            _zoomDecimation = settings.zoomDecimation;
+            _magnitudeLine.resize(settings.width);
+            _appliedSettings = settings;
+        }
 
-            /* Resize overlap samples buffer and DFT samples buffer if N changed */
-            if (overlapSamples.size() != _realDft.getSize()) {
-                overlapSamples.resize(_realDft.getSize());
-                dftSamples.resize(_realDft.getSize() / 2 + 1);
+        if (_zoomDecimation > 1) {
+            /* Mix and decimate new audio samples to baseband */
+            _zoomFilter.process(_basebandSamples, newAudioSamples);
+
+            /* Resize overlap baseband samples buffer if N changed */
+            if (_overlapBasebandSamples.size() != _complexDft->getSize())
+                _overlapBasebandSamples.resize(_complexDft->getSize());
+
+            /* Rows beyond the zoom filter passband, at both edges of the band */
+            size_t edge = static_cast<size_t>((0.5f - DFT::ZoomFilter::Passband) * static_cast<float>(_magnitudeLine.size()) + 0.5f);
+
+            /* Compute complex DFT of baseband for every hop available, quantized on a linear axis, with edges cropped to the floor */
+            while (shiftSamples(_overlapBasebandSamples, _basebandSamples, _samplesOverlap)) {
+                _complexDft->compute(_dftSamples, _overlapBasebandSamples);
+                _spectrumAverager.process(_dftSamples);
+                Spectrogram::SpectrumRenderer::quantize(_magnitudeLine, _dftSamples);
+                std::fill(_magnitudeLine.begin(), _magnitudeLine.begin() + static_cast<std::ptrdiff_t>(edge), 0);
+                std::fill(_magnitudeLine.end() - static_cast<std::ptrdiff_t>(edge), _magnitudeLine.end(), 0);
+                _emit(_magnitudeLine);
             }
+        } else {
+            /* Select spectrum engine */
+            DFT::SpectrumEngine *engine = _getEngine();
+
+            /* Frames are independent, except for the sliding DFT and polyphase filterbank histories */
+            bool batchFrames = _threadPool && _engine != DFT::SpectrumEngine::Type::SlidingDft && _engine != DFT::SpectrumEngine::Type::Polyphase;
+
+            /* Add new audio samples to our audio samples buffer */
+            _audioSamples.insert(_audioSamples.end(), newAudioSamples.begin(), newAudioSamples.end());
+
+            /* Resize overlap samples buffer if N changed */
+            if (_overlapSamples.size() != engine->getSize())
+                _overlapSamples.resize(engine->getSize());
+
+            /* Compute spectrum for every hop available */
+            while (shiftSamples(_overlapSamples, _audioSamples, _samplesOverlap)) {
+                if (batchFrames) {
+                    /* Batch frame for the frame workers */
+                    if (_frameCount == _frames.size())
+                        _frames.emplace_back();
+                    _frames[_frameCount++] = _overlapSamples;
+
+                    if (_frameCount == FramesPerWorker * _threadPool->getThreads())
+                        _flushFrames();
+                    continue;
+                }
+
+                engine->compute(_dftSamples, _overlapSamples);
+
+                /* Average spectrum in power */
+                _spectrumAverager.process(_dftSamples);
+
+                /* Quantize spectrogram line */
+                _quantize(_frequencyAxis, _magnitudeLine, _dftSamples);
+
+                /* Put into magnitudes queue */
+                _emit(_magnitudeLine);
+            }
+        }
+    }
+
+    /* Compute remaining batched frames */
+    _flushFrames();
+}
+
+DFT::SpectrumEngine *SpectrogramThread::_getEngine() {
+    if (_engine == DFT::SpectrumEngine::Type::ConstantQ)
+        return _constantQ.get();
+    else if (_engine == DFT::SpectrumEngine::Type::SlidingDft)
+        return _slidingDft.get();
+    else if (_engine == DFT::SpectrumEngine::Type::Goertzel)
+        return _goertzelBank.get();
+    else if (_engine == DFT::SpectrumEngine::Type::Multitaper)
+        return _multitaperDft.get();
+    else if (_engine == DFT::SpectrumEngine::Type::Polyphase)
+        return _polyphaseFilterbank.get();
+
+    return &_realDft;
+}
+
+void SpectrogramThread::_quantize(Spectrogram::FrequencyAxis &frequencyAxis, std::vector<uint16_t> &magnitudes, const std::vector<std::complex<float>> &dft) {
+    /* Quantize linearly across constant-Q bins or Goertzel tones, otherwise on the frequency axis */
+    if (_engine == DFT::SpectrumEngine::Type::ConstantQ || _engine == DFT::SpectrumEngine::Type::Goertzel)
+        Spectrogram::SpectrumRenderer::quantize(magnitudes, dft);
+    else
+        frequencyAxis.quantize(magnitudes, dft, _sampleRate);
+}
 
-            /* If we don't have enough samples to update overlap window, continue to pop more */
-            if (audioSamples.size() < _samplesOverlap)
-                continue;
+void SpectrogramThread::_emit(const std::vector<uint16_t> &magnitudes) {
+    if (_frameRing) {
+        const DftSettings &settings = _appliedSettings;
+        _frameRing->publish(magnitudes, {settings.dftSize, settings.samplesOverlap, static_cast<unsigned int>(settings.engine), static_cast<unsigned int>(settings.frequencyScale), settings.zoomDecimation, settings.zoomFrequency});
+    }
+
+    _magnitudesQueue.push(magnitudes);
+}
 
-            /* Move down overlapSamples.size()-samplesOverlap length old samples */
-            memmove(overlapSamples.data(), overlapSamples.data() + _samplesOverlap, sizeof(float) * (overlapSamples.size() - _samplesOverlap));
-            /* Copy overlapSamples.size()-samplesOverlap length new samples */
-            memcpy(overlapSamples.data() + _samplesOverlap, audioSamples.data(), sizeof(float) * (overlapSamples.size() - _samplesOverlap));
-            /* Erase used audio samples */
-            audioSamples.erase(audioSamples.begin(), audioSamples.begin() + _samplesOverlap);
+void SpectrogramThread::_flushFrames() {
+    if (_frameCount == 0)
+        return;
+
+    if (_frameDfts.size() < _frameCount) {
+        _frameDfts.resize(_frameCount);
+        _frameMagnitudes.resize(_frameCount);
+    }
 
-            /* Compute DFT */
-            _realDft.compute(dftSamples, overlapSamples);
+    if (_frameCount == 1) {
+        /* Compute a lone frame here */
+        _getEngine()->compute(_frameDfts[0], _frames[0]);
+    } else {
+        /* Frame workers pull frames from the pool queue as they finish, each with its own engine */
+        for (size_t i = 0; i < _frameCount; i++) {
+            _threadPool->submit([this, i](unsigned int index) {
+                FrameWorker &worker = _frameWorkers[index];
+
+                _updateFrameWorker(worker);
+                worker.engine->compute(_frameDfts[i], _frames[i]);
+
+                /* Without averaging, rows can be quantized out of order too */
+                if (_spectrumAverager.getMode() == Spectrogram::SpectrumAverager::Mode::None) {
+                    _frameMagnitudes[i].resize(_magnitudeLine.size());
+                    _quantize(*worker.frequencyAxis, _frameMagnitudes[i], _frameDfts[i]);
+                }
+            });
         }
 
-        {
-            /* Lock spectrum renderer */
-            std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-            /* Render spectrogram line */
-            _spectrumRenderer.render(_pixelLine, dftSamples);
+        _threadPool->wait();
+    }
+
+    /* Average, quantize, and emit rows in order */
+    for (size_t i = 0; i < _frameCount; i++) {
+        if (_frameCount == 1 || _spectrumAverager.getMode() != Spectrogram::SpectrumAverager::Mode::None) {
+            _spectrumAverager.process(_frameDfts[i]);
+            _frameMagnitudes[i].resize(_magnitudeLine.size());
+            _quantize(_frequencyAxis, _frameMagnitudes[i], _frameDfts[i]);
         }
 
-        /* Put into pixels queue */
-        _pixelsQueue.push(_pixelLine);
+        _emit(_frameMagnitudes[i]);
     }
+
+    _frameCount = 0;
+}
+
+void SpectrogramThread::_updateFrameWorker(FrameWorker &worker) {
+    const DftSettings &settings = _appliedSettings;
+
+    /* Rebuild engine when its configuration changes */
+    if (!worker.engine || worker.engineSettings.engine != settings.engine || worker.engineSettings.dftSize != settings.dftSize || worker.engineSettings.dftWindowFunction != settings.dftWindowFunction || worker.engineSettings.cqtBinsPerOctave != settings.cqtBinsPerOctave || worker.engineSettings.multitaperTapers != settings.multitaperTapers) {
+        if (settings.engine == DFT::SpectrumEngine::Type::ConstantQ)
+            worker.engine.reset(new DFT::ConstantQTransform(settings.dftSize, settings.dftWindowFunction, _sampleRate, settings.cqtBinsPerOctave, settings.cqtMinFrequency));
+        else if (settings.engine == DFT::SpectrumEngine::Type::Goertzel)
+            worker.engine.reset(new DFT::GoertzelBank(settings.dftSize, settings.dftWindowFunction, _sampleRate, _goertzelFrequencies));
+        else if (settings.engine == DFT::SpectrumEngine::Type::Multitaper)
+            worker.engine.reset(new DFT::MultitaperDft(settings.dftSize, settings.multitaperTapers));
+        else
+            worker.engine.reset(new DFT::RealDft(settings.dftSize, settings.dftWindowFunction));
+
+        worker.engineSettings = settings;
+    }
+
+    if (!worker.frequencyAxis)
+        worker.frequencyAxis.reset(new Spectrogram::FrequencyAxis(settings.frequencyScale));
+    if (worker.frequencyAxis->getScale() != settings.frequencyScale)
+        worker.frequencyAxis->setScale(settings.frequencyScale);
 }
 
 void SpectrogramThread::setWidth(unsigned int width) {
-    std::lock_guard<std::mutex> dftLg(_spectrumRendererLock);
-    _pixelLine.resize(width);
+    _settings.width = width;
+    _settingsSnapshot.publish(_settings);
 }
 
 float SpectrogramThread::getSamplesOverlap() {
-    std::lock_guard<std::mutex> dftLg(_realDftLock);
-    return static_cast<float>(_samplesOverlap) / static_cast<float>(_realDft.getSize());
+    return static_cast<float>(_settings.samplesOverlap) / static_cast<float>(_settings.dftSize);
 }
 
 void SpectrogramThread::setSamplesOverlap(float overlap) {
-    std::lock_guard<std::mutex> dftLg(_realDftLock);
-    _samplesOverlap = static_cast<unsigned int>(overlap * static_cast<float>(_realDft.getSize()));
+    _settings.samplesOverlap = static_cast<unsigned int>(overlap * static_cast<float>(_settings.dftSize));
+    _settingsSnapshot.publish(_settings);
 }
 
 unsigned int SpectrogramThread::getDftSize() {
-    std::lock_guard<std::mutex> dftLg(_realDftLock);
-    return _realDft.getSize();
+    return _settings.dftSize;
 }
 
 void SpectrogramThread::setDftSize(unsigned int N) {
     float overlap = getSamplesOverlap();
 
-    {
-        std::lock_guard<std::mutex> dftLg(_realDftLock);
-        _realDft.setSize(N);
-    }
+    _settings.dftSize = N;
 
     /* Preserve overlap percentage */
     setSamplesOverlap(overlap);
 }
 
 DFT::RealDft::WindowFunction SpectrogramThread::getDftWindowFunction() {
-    std::lock_guard<std::mutex> dftLg(_realDftLock);
-    return _realDft.getWindowFunction();
+    return _settings.dftWindowFunction;
 }
 
 void SpectrogramThread::setDftWindowFunction(DFT::RealDft::WindowFunction wf) {
-    std::lock_guard<std::mutex> dftLg(_realDftLock);
-    _realDft.setWindowFunction(wf);
+    _settings.dftWindowFunction = wf;
+    _settingsSnapshot.publish(_settings);
+}
+
+DFT::SpectrumEngine::Type SpectrogramThread::getEngine() {
+    return _settings.engine;
+}
+
+void SpectrogramThread::setEngine(DFT::SpectrumEngine::Type engine) {
+    _settings.engine = engine;
+    _settingsSnapshot.publish(_settings);
+}
+
+unsigned int SpectrogramThread::getCqtBinsPerOctave() {
+    return _settings.cqtBinsPerOctave;
+}
+
+void SpectrogramThread::setCqtBinsPerOctave(unsigned int binsPerOctave) {
+    _settings.cqtBinsPerOctave = binsPerOctave;
+    _settingsSnapshot.publish(_settings);
+}
+
+float SpectrogramThread::getCqtMinFrequency() {
+    return _settings.cqtMinFrequency;
+}
+
+Spectrogram::SpectrumAverager::Mode SpectrogramThread::getAverageMode() {
+    return _settings.averageMode;
+}
+
+void SpectrogramThread::setAverageMode(Spectrogram::SpectrumAverager::Mode mode) {
+    _settings.averageMode = mode;
+    _settingsSnapshot.publish(_settings);
+}
+
+float SpectrogramThread::getAverageAlpha() {
+    return _settings.averageAlpha;
+}
+
+unsigned int SpectrogramThread::getAverageFrames() {
+    return _settings.averageFrames;
+}
+
+unsigned int SpectrogramThread::getPfbTaps() {
+    return _settings.pfbTaps;
+}
+
+void SpectrogramThread::setPfbTaps(unsigned int taps) {
+    _settings.pfbTaps = taps;
+    _settingsSnapshot.publish(_settings);
+}
+
+unsigned int SpectrogramThread::getMultitaperTapers() {
+    return _settings.multitaperTapers;
 }
 
-float SpectrogramThread::getMagnitudeMin() {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    return _spectrumRenderer.getMagnitudeMin();
+void SpectrogramThread::setMultitaperTapers(unsigned int tapers) {
+    _settings.multitaperTapers = tapers;
+    _settingsSnapshot.publish(_settings);
 }
 
-void SpectrogramThread::setMagnitudeMin(float min) {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    _spectrumRenderer.setMagnitudeMin(min);
+const std::vector<float> &SpectrogramThread::getGoertzelFrequencies() {
+    return _goertzelFrequencies;
 }
 
-float SpectrogramThread::getMagnitudeMax() {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    return _spectrumRenderer.getMagnitudeMax();
+float SpectrogramThread::getZoomFrequency() {
+    return _settings.zoomFrequency;
 }
 
-void SpectrogramThread::setMagnitudeMax(float max) {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    _spectrumRenderer.setMagnitudeMax(max);
+void SpectrogramThread::setZoomFrequency(float frequency) {
+    /* Clamp to the audio band, as clicks near the edges of a zoomed band land outside it */
+    _settings.zoomFrequency = std::min<float>(std::max<float>(frequency, 0.0f), static_cast<float>(_sampleRate) / 2.0f);
+    _settingsSnapshot.publish(_settings);
 }
 
-bool SpectrogramThread::getMagnitudeLog() {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    return _spectrumRenderer.getMagnitudeLog();
+unsigned int SpectrogramThread::getZoomDecimation() {
+    return _settings.zoomDecimation;
 }
 
-void SpectrogramThread::setMagnitudeLog(bool logarithmic) {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    _spectrumRenderer.setMagnitudeLog(logarithmic);
+void SpectrogramThread::setZoomDecimation(unsigned int decimation) {
+    _settings.zoomDecimation = decimation;
+    _settingsSnapshot.publish(_settings);
 }
 
-Spectrogram::SpectrumRenderer::ColorScheme SpectrogramThread::getColorScheme() {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    return _spectrumRenderer.getColorScheme();
+Spectrogram::FrequencyAxis::Scale SpectrogramThread::getFrequencyScale() {
+    return _settings.frequencyScale;
 }
 
-void SpectrogramThread::setColorScheme(Spectrogram::SpectrumRenderer::ColorScheme colorScheme) {
-    std::lock_guard<std::mutex> spectrumLg(_spectrumRendererLock);
-    _spectrumRenderer.setColorScheme(colorScheme);
+void SpectrogramThread::setFrequencyScale(Spectrogram::FrequencyAxis::Scale scale) {
+    _settings.frequencyScale = scale;
+    _settingsSnapshot.publish(_settings);
 }
 
 size_t SpectrogramThread::getDebugSamplesQueueCount() {
@@ -3,19 +3,44 @@
 #include <vector>
 #include <atomic>
 #include <thread>
+#include <memory>
 
 #include "ThreadSafeQueue.hpp"
+#include "ThreadPool.hpp"
+#include "SnapshotBuffer.hpp"
+#include "SharedFrameRing.hpp"
 #include "dft/RealDft.hpp"
+#include "dft/ComplexDft.hpp"
+#include "dft/ConstantQTransform.hpp"
+#include "dft/SlidingDft.hpp"
+#include "dft/GoertzelBank.hpp"
+#include "dft/MultitaperDft.hpp"
+#include "dft/PolyphaseFilterbank.hpp"
+#include "dft/ZoomFilter.hpp"
 #include "spectrogram/SpectrumRenderer.hpp"
+#include "spectrogram/FrequencyAxis.hpp"
+#include "spectrogram/SpectrumAverager.hpp"
 #include "Configuration.hpp"
 
 class SpectrogramThread {
   public:
-    SpectrogramThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, ThreadSafeQueue<std::vector<uint32_t>> &pixelsQueue, const Configuration::Settings &initialSettings);
+    SpectrogramThread(ThreadSafeQueue<std::vector<float>> &samplesQueue, ThreadSafeQueue<std::vector<uint16_t>> &magnitudesQueue, const Configuration::Settings &initialSettings);
 
     void start();
     void stop();
 
+    /*
+     * Compute spectra of all queued samples, without blocking. Called by the
+     * DFT loop, or by a worker pool in place of start(), never concurrently.
+     */
+    void process();
+
+    /*
+     * Settings getters and setters are called from a single (interface) thread.
+     * Getters return that thread's copy of the settings without locking, and
+     * setters publish a snapshot that the DFT loop picks up at the next frame.
+     */
+
     /* Set Spectrogram Width */
     void setWidth(unsigned int width);
 
@@ -31,41 +56,144 @@ class SpectrogramThread {
     DFT::RealDft::WindowFunction getDftWindowFunction();
     void setDftWindowFunction(DFT::RealDft::WindowFunction wf);
 
-    /* Get/Set Spectrogram Magnitude Minimum */
-    float getMagnitudeMin();
-    void setMagnitudeMin(float min);
+    /* Get/Set Spectrum Engine */
+    DFT::SpectrumEngine::Type getEngine();
+    void setEngine(DFT::SpectrumEngine::Type engine);
+
+    /* Get/Set Constant-Q Bins per Octave */
+    unsigned int getCqtBinsPerOctave();
+    void setCqtBinsPerOctave(unsigned int binsPerOctave);
+
+    /* Get Constant-Q Requested Minimum Frequency in Hz */
+    float getCqtMinFrequency();
+
+    /* Get/Set Polyphase Filterbank Taps per Branch */
+    unsigned int getPfbTaps();
+    void setPfbTaps(unsigned int taps);
+
+    /* Get/Set Multitaper Number of Tapers */
+    unsigned int getMultitaperTapers();
+    void setMultitaperTapers(unsigned int tapers);
+
+    /* Get Goertzel Tone Frequencies in Hz */
+    const std::vector<float> &getGoertzelFrequencies();
+
+    /* Get/Set Averaging Mode */
+    Spectrogram::SpectrumAverager::Mode getAverageMode();
+    void setAverageMode(Spectrogram::SpectrumAverager::Mode mode);
+
+    /* Get Exponential Averaging Weight and Peak Hold Release */
+    float getAverageAlpha();
 
-    /* Get/Set Spectrogram Magnitude Maximum */
-    float getMagnitudeMax();
-    void setMagnitudeMax(float max);
+    /* Get Boxcar Averaging Frames */
+    unsigned int getAverageFrames();
 
-    /* Get/Set Spectrogram Magnitude Logarithmic/Linear */
-    bool getMagnitudeLog();
-    void setMagnitudeLog(bool logarithmic);
+    /* Get/Set Zoom Center Frequency in Hz, clamped to the audio band */
+    float getZoomFrequency();
+    void setZoomFrequency(float frequency);
 
-    /* Get/Set Spectrogram Color Scheme */
-    Spectrogram::SpectrumRenderer::ColorScheme getColorScheme();
-    void setColorScheme(Spectrogram::SpectrumRenderer::ColorScheme colorScheme);
+    /* Get/Set Zoom Decimation (1 disables zoom) */
+    unsigned int getZoomDecimation();
+    void setZoomDecimation(unsigned int decimation);
+
+    /* Get/Set Frequency Axis Scale */
+    Spectrogram::FrequencyAxis::Scale getFrequencyScale();
+    void setFrequencyScale(Spectrogram::FrequencyAxis::Scale scale);
 
     /* Debug Statistics */
     size_t getDebugSamplesQueueCount();
 
   private:
+    struct DftSettings {
+        unsigned int width;
+        unsigned int dftSize;
+        DFT::RealDft::WindowFunction dftWindowFunction;
+        unsigned int samplesOverlap;
+        DFT::SpectrumEngine::Type engine;
+        unsigned int cqtBinsPerOctave;
+        float cqtMinFrequency;
+        unsigned int multitaperTapers;
+        unsigned int pfbTaps;
+        Spectrogram::SpectrumAverager::Mode averageMode;
+        float averageAlpha;
+        unsigned int averageFrames;
+        float zoomFrequency;
+        unsigned int zoomDecimation;
+        Spectrogram::FrequencyAxis::Scale frequencyScale;
+    };
+
+    /* Frame worker, with its own spectrum engine and frequency axis */
+    struct FrameWorker {
+        std::unique_ptr<DFT::SpectrumEngine> engine;
+        DftSettings engineSettings;
+        std::unique_ptr<Spectrogram::FrequencyAxis> frequencyAxis;
+    };
+
+    /* Frames batched per worker thread, bounding added latency */
+    static constexpr size_t FramesPerWorker = 4;
+
     void _run();
 
-    /* Input samples queue */
-    ThreadSafeQueue<std::vector<float>> &_samplesQueue;
-    /* Output pixels queue */
-    ThreadSafeQueue<std::vector<uint32_t>> &_pixelsQueue;
+    /* Get selected spectrum engine */
+    DFT::SpectrumEngine *_getEngine();
 
-    DFT::RealDft _realDft;
-    std::mutex _realDftLock;
+    /* Compute batched frames on the frame workers, emitting rows in order */
+    void _flushFrames();
+    void _updateFrameWorker(FrameWorker &worker);
+    void _quantize(Spectrogram::FrequencyAxis &frequencyAxis, std::vector<uint16_t> &magnitudes, const std::vector<std::complex<float>> &dft);
 
-    Spectrogram::SpectrumRenderer _spectrumRenderer;
-    std::mutex _spectrumRendererLock;
+    /* Push a row into the magnitudes queue, and publish it to the shared frame ring */
+    void _emit(const std::vector<uint16_t> &magnitudes);
 
-    std::vector<uint32_t> _pixelLine;
+    /* Input samples queue */
+    ThreadSafeQueue<std::vector<float>> &_samplesQueue;
+    /* Output quantized magnitudes queue */
+    ThreadSafeQueue<std::vector<uint16_t>> &_magnitudesQueue;
+    /* Optional output shared frame ring, owned by the DFT loop */
+    std::unique_ptr<SharedFrameRing> _frameRing;
+
+    /* Settings, as last set by the interface thread */
+    DftSettings _settings;
+    /* Settings snapshot, published by the interface thread to the DFT loop */
+    SnapshotBuffer<DftSettings> _settingsSnapshot;
+    /* Settings last applied by the DFT loop */
+    DftSettings _appliedSettings;
+
+    /* Owned by the DFT loop */
+    std::vector<float> _audioSamples;
+    std::vector<float> _overlapSamples;
+    std::vector<std::complex<float>> _basebandSamples;
+    std::vector<std::complex<float>> _overlapBasebandSamples;
+    std::vector<std::complex<float>> _dftSamples;
+    DFT::RealDft _realDft;
+    std::vector<uint16_t> _magnitudeLine;
     unsigned int _samplesOverlap;
+    const unsigned int _sampleRate;
+    const std::vector<float> _goertzelFrequencies;
+    Spectrogram::FrequencyAxis _frequencyAxis;
+    Spectrogram::SpectrumAverager _spectrumAverager;
+
+    /* Alternative spectrum engines, owned by the DFT loop */
+    DFT::SpectrumEngine::Type _engine;
+    std::unique_ptr<DFT::ConstantQTransform> _constantQ;
+    std::unique_ptr<DFT::SlidingDft> _slidingDft;
+    std::unique_ptr<DFT::GoertzelBank> _goertzelBank;
+    std::unique_ptr<DFT::MultitaperDft> _multitaperDft;
+    std::unique_ptr<DFT::PolyphaseFilterbank> _polyphaseFilterbank;
+
+    /* Frame workers for independent overlapped frames, owned by the DFT loop */
+    std::unique_ptr<ThreadPool> _threadPool;
+    std::vector<FrameWorker> _frameWorkers;
+    std::vector<std::vector<float>> _frames;
+    std::vector<std::vector<std::complex<float>>> _frameDfts;
+    std::vector<std::vector<uint16_t>> _frameMagnitudes;
+    size_t _frameCount = 0;
+
+    /* Baseband zoom front-end and complex DFT, owned by the DFT loop */
+    DFT::ZoomFilter _zoomFilter;
+    std::unique_ptr<DFT::ComplexDft> _complexDft;
+    unsigned int _zoomDecimation;
+
     std::atomic<size_t> _samplesQueueCount;
 
     std::atomic<bool> _running;
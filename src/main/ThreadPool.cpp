@@ -0,0 +1,86 @@
+#include <algorithm>
+
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int threads) {
+    for (unsigned int i = 0; i < threads; i++)
+        _threads.emplace_back(&ThreadPool::_run, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lg(_lock);
+        _tasks.clear();
+        _running = false;
+        _cvTasks.notify_all();
+    }
+
+    for (auto &thread : _threads)
+        thread.join();
+}
+
+void ThreadPool::submit(std::function<void(unsigned int)> task) {
+    std::lock_guard<std::mutex> lg(_lock);
+    _tasks.push_back(std::move(task));
+    _cvTasks.notify_one();
+}
+
+void ThreadPool::clear() {
+    std::lock_guard<std::mutex> lg(_lock);
+    _tasks.clear();
+    if (_busy == 0)
+        _cvIdle.notify_all();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lg(_lock);
+
+    while (!_tasks.empty() || _busy > 0)
+        _cvIdle.wait(lg);
+
+    if (_exception) {
+        std::exception_ptr exception = _exception;
+        _exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+unsigned int ThreadPool::getThreads() {
+    return static_cast<unsigned int>(_threads.size());
+}
+
+unsigned int ThreadPool::defaultThreads() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void ThreadPool::_run(unsigned int index) {
+    std::unique_lock<std::mutex> lg(_lock);
+
+    while (true) {
+        while (_running && _tasks.empty())
+            _cvTasks.wait(lg);
+
+        if (!_running)
+            break;
+
+        std::function<void(unsigned int)> task(std::move(_tasks.front()));
+        _tasks.pop_front();
+        _busy++;
+
+        /* Run task unlocked */
+        lg.unlock();
+        try {
+            task(index);
+        } catch (...) {
+            lg.lock();
+            if (!_exception)
+                _exception = std::current_exception();
+            lg.unlock();
+        }
+        lg.lock();
+
+        _busy--;
+        if (_busy == 0 && _tasks.empty())
+            _cvIdle.notify_all();
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+
+class ThreadPool {
+  public:
+    ThreadPool(unsigned int threads);
+    ~ThreadPool();
+
+    /* Submit a task, called with the index of the worker running it */
+    void submit(std::function<void(unsigned int)> task);
+
+    /* Drop all queued tasks */
+    void clear();
+
+    /* Wait for all queued and running tasks to complete, rethrowing the first task exception */
+    void wait();
+
+    /* Get number of worker threads */
+    unsigned int getThreads();
+
+    /* Default number of worker threads (one per core) */
+    static unsigned int defaultThreads();
+
+  private:
+    void _run(unsigned int index);
+
+    std::mutex _lock;
+    std::condition_variable _cvTasks;
+    std::condition_variable _cvIdle;
+    std::deque<std::function<void(unsigned int)>> _tasks;
+    unsigned int _busy = 0;
+    std::exception_ptr _exception;
+    bool _running = true;
+
+    std::vector<std::thread> _threads;
+};
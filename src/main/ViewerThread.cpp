@@ -0,0 +1,749 @@
+#include <cstring>
+#include <algorithm>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "ViewerThread.hpp"
+#include "Configuration.hpp"
+
+using namespace Audio;
+using namespace DFT;
+using namespace Spectrogram;
+using namespace Configuration;
+
+/* Rows per tile */
+static const size_t TileRows = 256;
+/* Tile cache capacity in tiles */
+static const size_t TileCacheCapacity = 256;
+
+static uint64_t tileKey(unsigned int level, size_t index) {
+    return (static_cast<uint64_t>(level) << 48) | static_cast<uint64_t>(index);
+}
+
+static std::string formatTime(float seconds) {
+    unsigned int minutes = static_cast<unsigned int>(seconds / 60.0f);
+    return format("%u:%02u:%04.1f", minutes / 60, minutes % 60, seconds - 60.0f * static_cast<float>(minutes));
+}
+
+ViewerThread::ViewerThread(std::string audioPath, const Settings &initialSettings) : _audioPath(audioPath), _dftSize(initialSettings.dftSize), _dftWindowFunction(initialSettings.dftWindowFunction), _spectrumRenderer(initialSettings.magnitudeMin, initialSettings.magnitudeMax, initialSettings.magnitudeLog, initialSettings.colorScheme), _tileCache(TileCacheCapacity), _tilesUpdated(false), _threadPool(ThreadPool::defaultThreads()), _fullscreen(initialSettings.fullscreen), _width(initialSettings.width), _height(initialSettings.height), _orientation(initialSettings.orientation) {
+    int ret;
+
+    /* Query audio file sample rate and length */
+    {
+        WaveAudioSource audioSource(_audioPath);
+        _sampleRate = audioSource.getSampleRate();
+        _length = audioSource.getLength();
+    }
+
+    /* Hop between rows at full resolution */
+    _samplesHop = std::max<size_t>(_dftSize - static_cast<size_t>(initialSettings.samplesOverlap * static_cast<float>(_dftSize)), 1);
+
+    /* Per-worker audio source and DFT, created on first use */
+    _workers.resize(_threadPool.getThreads());
+
+    /* Initialize SDL */
+    ret = SDL_Init(SDL_INIT_VIDEO);
+    if (ret < 0)
+        throw SDLException("Unable to initialize SDL: SDL_Init(): " + std::string(SDL_GetError()));
+
+    /* Initialize TTF */
+    ret = TTF_Init();
+    if (ret < 0)
+        throw TTFException("Unable to initialize TTF: TTF_Init(): " + std::string(TTF_GetError()));
+
+    /* Query resolution for fullscreen mode */
+    if (_fullscreen) {
+        SDL_DisplayMode displayMode;
+        if (SDL_GetDesktopDisplayMode(0, &displayMode) < 0)
+            throw SDLException("Querying display mode: SDL_GetDesktopDisplayMode(): " + std::string(SDL_GetError()));
+
+        _width = static_cast<unsigned int>(displayMode.w);
+        _height = static_cast<unsigned int>(displayMode.h);
+    }
+
+    /* Create Window */
+    _win = SDL_CreateWindow(("audioprism - " + _audioPath).c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, static_cast<int>(_width), static_cast<int>(_height), SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL | (_fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0));
+    if (_win == nullptr)
+        throw SDLException("Creating SDL window: SDL_CreateWindow(): " + std::string(SDL_GetError()));
+
+    /* Create Renderer */
+    _renderer = SDL_CreateRenderer(_win, -1, SDL_RENDERER_ACCELERATED);
+    if (_renderer == nullptr)
+        throw SDLException("Creating SDL renderer: SDL_CreateRenderer(): " + std::string(SDL_GetError()));
+
+    /* Allocate pixel buffer */
+    _pixels.resize(_width * _height);
+    _tileWidth = getSpectrumWidth();
+
+    /* Create main texture */
+    _pixelsTexture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STATIC, static_cast<int>(getSpectrumWidth()), static_cast<int>(getTimeWidth()));
+    if (_pixelsTexture == nullptr)
+        throw SDLException("Creating SDL texture: SDL_CreateTexture(): " + std::string(SDL_GetError()));
+
+    /* Find a compatible font */
+    std::string fontPath = findFontPath();
+    if (fontPath == "")
+        throw TTFException("Could not find a compatible TTF font.");
+
+    /* Open font */
+    _font = TTF_OpenFont(fontPath.c_str(), 11);
+    if (_font == nullptr)
+        throw TTFException("Opening TTF font: TTF_OpenFont(): " + std::string(TTF_GetError()));
+
+    /* Start zoomed out to the whole file */
+    _level = _getMaxLevel();
+}
+
+ViewerThread::~ViewerThread() {
+    TTF_CloseFont(_font);
+    if (_pixelsTexture)
+        SDL_DestroyTexture(_pixelsTexture);
+    if (_settingsTexture)
+        SDL_DestroyTexture(_settingsTexture);
+    if (_cursorTexture)
+        SDL_DestroyTexture(_cursorTexture);
+    if (_statisticsTexture)
+        SDL_DestroyTexture(_statisticsTexture);
+    if (_helpTexture)
+        SDL_DestroyTexture(_helpTexture);
+
+    SDL_DestroyRenderer(_renderer);
+    SDL_DestroyWindow(_win);
+    TTF_Quit();
+    SDL_Quit();
+}
+
+size_t ViewerThread::_getSamplesPerRow(unsigned int level) {
+    return _samplesHop << level;
+}
+
+size_t ViewerThread::_getRows(unsigned int level) {
+    return std::max<size_t>((_length + _getSamplesPerRow(level) - 1) / _getSamplesPerRow(level), 1);
+}
+
+unsigned int ViewerThread::_getMaxLevel() {
+    unsigned int level = 0;
+
+    /* Smallest zoom level that fits the whole file in the window */
+    while (_getRows(level) > getTimeWidth() && level < 40)
+        level++;
+
+    return level;
+}
+
+void ViewerThread::_setView(unsigned int level, size_t row) {
+    size_t rows = _getRows(level);
+    size_t maxRow = (rows > getTimeWidth()) ? rows - getTimeWidth() : 0;
+
+    row = std::min(row, maxRow);
+
+    /* Track pan direction for prefetching */
+    if (level == _level && row != _viewRow)
+        _panDirection = (row > _viewRow) ? 1 : -1;
+
+    _level = level;
+    _viewRow = row;
+
+    _requestTiles();
+    _renderPixels();
+
+    if (!_hideSettings)
+        _renderSettings();
+}
+
+void ViewerThread::_zoom(int direction, unsigned int timePosition) {
+    unsigned int level = _level;
+
+    if (direction > 0 && level > 0)
+        level--;
+    else if (direction < 0 && level < _getMaxLevel())
+        level++;
+    else
+        return;
+
+    /* Keep the sample under the time position fixed */
+    size_t sample = (_viewRow + timePosition) * _getSamplesPerRow(_level);
+    size_t row = sample / _getSamplesPerRow(level);
+
+    _setView(level, (row > timePosition) ? row - timePosition : 0);
+}
+
+void ViewerThread::_requestTiles() {
+    size_t maxTile = (_getRows(_level) - 1) / TileRows;
+    size_t firstTile = _viewRow / TileRows;
+    size_t lastTile = std::min((_viewRow + getTimeWidth() - 1) / TileRows, maxTile);
+    size_t screenTiles = lastTile - firstTile + 1;
+
+    /* Visible tiles first */
+    std::vector<size_t> tiles;
+    for (size_t index = firstTile; index <= lastTile; index++)
+        tiles.push_back(index);
+
+    /* Then prefetch a screen of tiles in the pan direction */
+    for (size_t i = 1; i <= screenTiles; i++) {
+        if (_panDirection > 0 && lastTile + i <= maxTile)
+            tiles.push_back(lastTile + i);
+        else if (_panDirection < 0 && firstTile >= i)
+            tiles.push_back(firstTile - i);
+    }
+
+    std::lock_guard<std::mutex> tilesLg(_tilesLock);
+
+    /* Drop stale requests */
+    _threadPool.clear();
+    _queuedTiles.clear();
+
+    for (size_t index : tiles) {
+        uint64_t key = tileKey(_level, index);
+
+        if (_tileCache.contains(key) || _runningTiles.count(key) > 0 || _failedTiles.count(key) > 0)
+            continue;
+
+        unsigned int level = _level;
+        unsigned int width = _tileWidth;
+
+        _queuedTiles.insert(key);
+        _threadPool.submit([this, key, level, index, width](unsigned int worker) { _computeTile(worker, key, level, index, width); });
+    }
+}
+
+void ViewerThread::_computeTile(unsigned int worker, uint64_t key, unsigned int level, size_t index, unsigned int width) {
+    {
+        std::lock_guard<std::mutex> tilesLg(_tilesLock);
+
+        /* Skip if request was dropped */
+        if (_queuedTiles.erase(key) == 0)
+            return;
+
+        _runningTiles.insert(key);
+    }
+
+    Worker &w = _workers[worker];
+    std::vector<uint16_t> tile(TileRows * width, 0);
+
+    try {
+        if (!w.audioSource) {
+            w.audioSource.reset(new WaveAudioSource(_audioPath));
+            w.realDft.reset(new RealDft(_dftSize, _dftWindowFunction));
+            w.samples.resize(_dftSize);
+        }
+
+        size_t samplesPerRow = _getSamplesPerRow(level);
+        size_t rows = std::min(TileRows, _getRows(level) - index * TileRows);
+
+        w.magnitudes.resize(width);
+
+        for (size_t r = 0; r < rows; r++) {
+            if (r == 0 || samplesPerRow >= _dftSize) {
+                /* Seek and read a whole DFT window, zero padding past the end */
+                w.newSamples.resize(_dftSize);
+                w.audioSource->seek((index * TileRows + r) * samplesPerRow);
+                w.audioSource->read(w.newSamples);
+                w.newSamples.resize(_dftSize);
+
+                memcpy(w.samples.data(), w.newSamples.data(), sizeof(float) * _dftSize);
+            } else {
+                /* Slide DFT window by samples per row, zero padding past the end */
+                w.newSamples.resize(samplesPerRow);
+                w.audioSource->read(w.newSamples);
+                w.newSamples.resize(samplesPerRow);
+
+                memmove(w.samples.data(), w.samples.data() + samplesPerRow, sizeof(float) * (_dftSize - samplesPerRow));
+                memcpy(w.samples.data() + (_dftSize - samplesPerRow), w.newSamples.data(), sizeof(float) * samplesPerRow);
+            }
+
+            /* Compute DFT */
+            w.realDft->compute(w.dft, w.samples);
+
+            /* Quantize into tile row */
+            SpectrumRenderer::quantize(w.magnitudes, w.dft);
+            std::copy(w.magnitudes.begin(), w.magnitudes.end(), tile.begin() + static_cast<std::ptrdiff_t>(r * width));
+        }
+    } catch (...) {
+        /* Record failure for run(), as the pool is never waited on */
+        std::lock_guard<std::mutex> tilesLg(_tilesLock);
+        _runningTiles.erase(key);
+        _failedTiles.insert(key);
+        if (!_tileException)
+            _tileException = std::current_exception();
+        _tilesUpdated = true;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> tilesLg(_tilesLock);
+        _runningTiles.erase(key);
+
+        /* Discard tile if window was resized while computing */
+        if (width == _tileWidth)
+            _tileCache.put(key, std::move(tile));
+    }
+
+    _tilesUpdated = true;
+}
+
+void ViewerThread::_renderPixels() {
+    size_t timeWidth = getTimeWidth(), spectrumWidth = getSpectrumWidth();
+    size_t rows = _getRows(_level);
+
+    std::lock_guard<std::mutex> tilesLg(_tilesLock);
+
+    const std::vector<uint16_t> *tile = nullptr;
+    size_t tileIndex = SIZE_MAX;
+
+    for (size_t i = 0; i < timeWidth; i++) {
+        size_t row = _viewRow + i;
+        uint32_t *pixels = _pixels.data() + i * spectrumWidth;
+
+        /* Look up tile for this row */
+        if (row < rows && row / TileRows != tileIndex) {
+            tileIndex = row / TileRows;
+            tile = _tileCache.get(tileKey(_level, tileIndex));
+        }
+
+        /* Rows past the end of file or with tiles not yet computed are blank */
+        if (row >= rows || tile == nullptr || tile->size() != TileRows * spectrumWidth)
+            std::fill(pixels, pixels + spectrumWidth, 0);
+        else
+            _spectrumRenderer.render(pixels, tile->data() + (row % TileRows) * spectrumWidth, spectrumWidth);
+    }
+
+    SDL_UpdateTexture(_pixelsTexture, nullptr, _pixels.data(), static_cast<int>(spectrumWidth * sizeof(uint32_t)));
+}
+
+void ViewerThread::_renderSettings() {
+    std::vector<SDL_Surface *> textSurfaces;
+    SDL_Surface *settingsSurface;
+    SDL_Color settingsColor = {0xff, 0x00, 0x00, 0x00};
+
+    float secondsPerRow = static_cast<float>(_getSamplesPerRow(_level)) / static_cast<float>(_sampleRate);
+    float viewStart = static_cast<float>(_viewRow) * secondsPerRow;
+    float viewEnd = std::min(static_cast<float>(_viewRow + getTimeWidth()) * secondsPerRow, static_cast<float>(_length) / static_cast<float>(_sampleRate));
+
+    textSurfaces.push_back(renderString(format("Sample Rate: %d Hz", _sampleRate), _font, settingsColor));
+    textSurfaces.push_back(renderString("Window: " + to_string(_dftWindowFunction), _font, settingsColor));
+    textSurfaces.push_back(renderString(format("DFT Size: %d", _dftSize), _font, settingsColor));
+    textSurfaces.push_back(renderString(format("Zoom: %u samples/row", _getSamplesPerRow(_level)), _font, settingsColor));
+    textSurfaces.push_back(renderString("View: " + formatTime(viewStart) + " - " + formatTime(viewEnd), _font, settingsColor));
+    textSurfaces.push_back(renderString(format("Colors: %s", to_string(_spectrumRenderer.getColorScheme()).c_str()), _font, settingsColor));
+    if (_spectrumRenderer.getMagnitudeLog()) {
+        textSurfaces.push_back(renderString(format("Mag. min: %.2f dB", _spectrumRenderer.getMagnitudeMin()), _font, settingsColor));
+        textSurfaces.push_back(renderString(format("Mag. max: %.2f dB", _spectrumRenderer.getMagnitudeMax()), _font, settingsColor));
+        textSurfaces.push_back(renderString(format("Mag. Logarithmic"), _font, settingsColor));
+    } else {
+        textSurfaces.push_back(renderString(format("Mag. min: %.2f", _spectrumRenderer.getMagnitudeMin()), _font, settingsColor));
+        textSurfaces.push_back(renderString(format("Mag. max: %.2f", _spectrumRenderer.getMagnitudeMax()), _font, settingsColor));
+        textSurfaces.push_back(renderString(format("Mag. Linear"), _font, settingsColor));
+    }
+
+    settingsSurface = vcatSurfaces(textSurfaces, Alignment::Right);
+
+    /* Update settings rectangle destination for screen rendering */
+    _settingsRect.x = static_cast<int>(_width) - settingsSurface->w - 5;
+    _settingsRect.y = 2;
+    _settingsRect.w = settingsSurface->w;
+    _settingsRect.h = settingsSurface->h;
+
+    /* Destroy old settings texture */
+    if (_settingsTexture)
+        SDL_DestroyTexture(_settingsTexture);
+
+    /* Create new texture from the target surface */
+    _settingsTexture = SDL_CreateTextureFromSurface(_renderer, settingsSurface);
+    if (_settingsTexture == nullptr)
+        throw SDLException("Error creating texture for settings text: SDL_CreateTextureFromSurface(): " + std::string(SDL_GetError()));
+
+    SDL_FreeSurface(settingsSurface);
+}
+
+void ViewerThread::_renderCursor(int x, int y) {
+    SDL_Surface *cursorSurface;
+    SDL_Color settingsColor = {0xff, 0x00, 0x00, 0x00};
+
+    float frequency;
+    int timePosition;
+
+    float hzPerBin = ((static_cast<float>(_sampleRate)) / 2.0f) / static_cast<float>((_dftSize / 2 + 1));
+
+    if (_orientation == Orientation::Vertical) {
+        float binPerPixel = static_cast<float>((_dftSize / 2 + 1)) / static_cast<float>(_width);
+        frequency = std::floor(static_cast<float>(x) * binPerPixel) * hzPerBin;
+        timePosition = y;
+    } else {
+        float binPerPixel = static_cast<float>((_dftSize / 2 + 1)) / static_cast<float>(_height);
+        frequency = std::floor(static_cast<float>(static_cast<int>(_height) - y) * binPerPixel) * hzPerBin;
+        timePosition = x;
+    }
+
+    float time = static_cast<float>((_viewRow + static_cast<size_t>(std::max(timePosition, 0))) * _getSamplesPerRow(_level)) / static_cast<float>(_sampleRate);
+
+    cursorSurface = renderString(format("%.0f Hz  ", frequency) + formatTime(time), _font, settingsColor);
+
+    /* Update cursor rectangle destination for screen rendering */
+    _cursorRect.x = static_cast<int>(_width) - cursorSurface->w - 5;
+    _cursorRect.y = _settingsRect.y + _settingsRect.h + cursorSurface->h;
+    _cursorRect.w = cursorSurface->w;
+    _cursorRect.h = cursorSurface->h;
+
+    /* Destroy old cursor texture */
+    if (_cursorTexture)
+        SDL_DestroyTexture(_cursorTexture);
+
+    /* Create new texture from the target surface */
+    _cursorTexture = SDL_CreateTextureFromSurface(_renderer, cursorSurface);
+    if (_cursorTexture == nullptr)
+        throw SDLException("Error creating texture for cursor text: SDL_CreateTextureFromSurface(): " + std::string(SDL_GetError()));
+
+    SDL_FreeSurface(cursorSurface);
+}
+
+void ViewerThread::_renderStatistics() {
+    std::vector<SDL_Surface *> textSurfaces;
+    SDL_Surface *statisticsSurface;
+    SDL_Color statisticsColor = {0xff, 0x00, 0x00, 0x00};
+
+    size_t cachedTiles, pendingTiles;
+    {
+        std::lock_guard<std::mutex> tilesLg(_tilesLock);
+        cachedTiles = _tileCache.getCount();
+        pendingTiles = _queuedTiles.size() + _runningTiles.size();
+    }
+
+    textSurfaces.push_back(renderString(format("Tiles Cached: %u", cachedTiles), _font, statisticsColor));
+    textSurfaces.push_back(renderString(format("Tiles Pending: %u", pendingTiles), _font, statisticsColor));
+    textSurfaces.push_back(renderString(format("Workers: %u", _threadPool.getThreads()), _font, statisticsColor));
+    statisticsSurface = vcatSurfaces(textSurfaces, Alignment::Right);
+
+    /* Update statistics rectangle destination for screen rendering */
+    _statisticsRect.x = static_cast<int>(_width) - statisticsSurface->w - 5;
+    _statisticsRect.y = _cursorRect.y + _cursorRect.h * 2;
+    _statisticsRect.w = statisticsSurface->w;
+    _statisticsRect.h = statisticsSurface->h;
+
+    /* Destroy old statistics texture */
+    if (_statisticsTexture)
+        SDL_DestroyTexture(_statisticsTexture);
+
+    /* Create new texture from the target surface */
+    _statisticsTexture = SDL_CreateTextureFromSurface(_renderer, statisticsSurface);
+    if (_statisticsTexture == nullptr)
+        throw SDLException("Error creating texture for statistics text: SDL_CreateTextureFromSurface(): " + std::string(SDL_GetError()));
+
+    SDL_FreeSurface(statisticsSurface);
+}
+
+void ViewerThread::_renderHelp() {
+    std::vector<SDL_Surface *> textSurfaces;
+    SDL_Surface *textSurface;
+    SDL_Surface *helpSurface;
+    SDL_Color helpColor = {0xff, 0xff, 0x00, 0x00};
+
+    textSurfaces.push_back(renderString("q      Quit", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("f      Toggle fullscreen", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("h      Hide/show help", _font, helpColor));
+    textSurfaces.push_back(renderString("s      Hide/show settings", _font, helpColor));
+    textSurfaces.push_back(renderString("d      Hide/show debug stats", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("c      Cycle color scheme", _font, helpColor));
+    textSurfaces.push_back(renderString("l      Cycle linear/log magnitude", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("-      Decrease min magnitude", _font, helpColor));
+    textSurfaces.push_back(renderString("=      Increase min magnitude", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("[      Decrease max magnitude", _font, helpColor));
+    textSurfaces.push_back(renderString("]      Increase max magnitude", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("i      Zoom in", _font, helpColor));
+    textSurfaces.push_back(renderString("o      Zoom out", _font, helpColor));
+    textSurfaces.push_back(renderString("Wheel  Zoom at cursor", _font, helpColor));
+    textSurfaces.push_back(renderString(" ", _font, helpColor));
+    textSurfaces.push_back(renderString("Up     Pan back", _font, helpColor));
+    textSurfaces.push_back(renderString("Down   Pan forward", _font, helpColor));
+    textSurfaces.push_back(renderString("PgUp   Pan back one screen", _font, helpColor));
+    textSurfaces.push_back(renderString("PgDn   Pan forward one screen", _font, helpColor));
+    textSurfaces.push_back(renderString("Home   Jump to start", _font, helpColor));
+    textSurfaces.push_back(renderString("End    Jump to end", _font, helpColor));
+    textSurfaces.push_back(renderString("Drag   Pan", _font, helpColor));
+    textSurface = vcatSurfaces(textSurfaces, Alignment::Left);
+
+    /* Create background surface */
+    helpSurface = SDL_CreateRGBSurface(0, textSurface->w + 10, textSurface->h + 10, 32, SDL_R_MASK, SDL_G_MASK, SDL_B_MASK, SDL_A_MASK);
+    if (helpSurface == nullptr)
+        throw SDLException("Error creating help background surface: SDL_CreateRGBSurface(): " + std::string(SDL_GetError()));
+
+    if (SDL_FillRect(helpSurface, nullptr, SDL_MapRGBA(helpSurface->format, 0xff, 0xff, 0xff, 0x20)) < 0)
+        throw SDLException("Error filling help background surface: SDL_FillRect(): " + std::string(SDL_GetError()));
+
+    /* Blit text surface onto background surface */
+    SDL_Rect targetRect = {(helpSurface->w - textSurface->w) / 2, (helpSurface->h - textSurface->h) / 2, textSurface->w, textSurface->h};
+
+    if (SDL_BlitSurface(textSurface, nullptr, helpSurface, &targetRect) < 0)
+        throw SDLException("Error blitting text surfaces: SDL_BlitSurface(): " + std::string(SDL_GetError()));
+
+    SDL_FreeSurface(textSurface);
+
+    /* Update help rectangle destination for screen rendering */
+    _helpRect.x = (static_cast<int>(_width) - helpSurface->w) / 2;
+    _helpRect.y = (static_cast<int>(_height) - helpSurface->h) / 2;
+    _helpRect.w = helpSurface->w;
+    _helpRect.h = helpSurface->h;
+
+    /* Destroy old help texture */
+    if (_helpTexture)
+        SDL_DestroyTexture(_helpTexture);
+
+    /* Create new texture from the target surface */
+    _helpTexture = SDL_CreateTextureFromSurface(_renderer, helpSurface);
+    if (_helpTexture == nullptr)
+        throw SDLException("Error creating texture for help text: SDL_CreateTextureFromSurface(): " + std::string(SDL_GetError()));
+
+    SDL_FreeSurface(helpSurface);
+}
+
+void ViewerThread::_handleKeyDown(const uint8_t *state) {
+    if (state[SDL_SCANCODE_Q]) {
+        _running = false;
+        return;
+    } else if (state[SDL_SCANCODE_C]) {
+        /* Change color scheme */
+        SpectrumRenderer::ColorScheme colorScheme = _spectrumRenderer.getColorScheme();
+
+        if (colorScheme == SpectrumRenderer::ColorScheme::Heat)
+            _spectrumRenderer.setColorScheme(SpectrumRenderer::ColorScheme::Blue);
+        else if (colorScheme == SpectrumRenderer::ColorScheme::Blue)
+            _spectrumRenderer.setColorScheme(SpectrumRenderer::ColorScheme::Grayscale);
+        else if (colorScheme == SpectrumRenderer::ColorScheme::Grayscale)
+            _spectrumRenderer.setColorScheme(SpectrumRenderer::ColorScheme::Heat);
+    } else if (state[SDL_SCANCODE_L]) {
+        /* Toggle between Logarithimic/Linear */
+        bool magnitudeLog = !_spectrumRenderer.getMagnitudeLog();
+
+        _spectrumRenderer.setMagnitudeLog(magnitudeLog);
+        if (magnitudeLog) {
+            _spectrumRenderer.setMagnitudeMin(InitialSettings.magnitudeLogMin);
+            _spectrumRenderer.setMagnitudeMax(InitialSettings.magnitudeLogMax);
+        } else {
+            _spectrumRenderer.setMagnitudeMin(InitialSettings.magnitudeLinearMin);
+            _spectrumRenderer.setMagnitudeMax(InitialSettings.magnitudeLinearMax);
+        }
+    } else if (state[SDL_SCANCODE_MINUS] || state[SDL_SCANCODE_EQUALS]) {
+        /* Magnitude min down/up */
+        float magnitudeMin = _spectrumRenderer.getMagnitudeMin(), magnitudeMax = _spectrumRenderer.getMagnitudeMax();
+        float step = _spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogStep : UserLimits.magnitudeLinearStep;
+        float limit = _spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogMin : UserLimits.magnitudeLinearMin;
+
+        if (state[SDL_SCANCODE_MINUS])
+            _spectrumRenderer.setMagnitudeMin(std::max<float>(magnitudeMin - step, limit));
+        else
+            _spectrumRenderer.setMagnitudeMin(std::min<float>(magnitudeMin + step, magnitudeMax - step));
+    } else if (state[SDL_SCANCODE_LEFTBRACKET] || state[SDL_SCANCODE_RIGHTBRACKET]) {
+        /* Magnitude max down/up */
+        float magnitudeMin = _spectrumRenderer.getMagnitudeMin(), magnitudeMax = _spectrumRenderer.getMagnitudeMax();
+        float step = _spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogStep : UserLimits.magnitudeLinearStep;
+        float limit = _spectrumRenderer.getMagnitudeLog() ? UserLimits.magnitudeLogMax : UserLimits.magnitudeLinearMax;
+
+        if (state[SDL_SCANCODE_LEFTBRACKET])
+            _spectrumRenderer.setMagnitudeMax(std::max<float>(magnitudeMax - step, magnitudeMin + step));
+        else
+            _spectrumRenderer.setMagnitudeMax(std::min<float>(magnitudeMax + step, limit));
+    } else if (state[SDL_SCANCODE_I]) {
+        /* Zoom in at center */
+        _zoom(1, getTimeWidth() / 2);
+        return;
+    } else if (state[SDL_SCANCODE_O]) {
+        /* Zoom out at center */
+        _zoom(-1, getTimeWidth() / 2);
+        return;
+    } else if (state[SDL_SCANCODE_UP] || state[SDL_SCANCODE_LEFT]) {
+        /* Pan back a tenth of a screen */
+        size_t rows = std::max<size_t>(getTimeWidth() / 10, 1);
+        _setView(_level, (_viewRow > rows) ? _viewRow - rows : 0);
+        return;
+    } else if (state[SDL_SCANCODE_DOWN] || state[SDL_SCANCODE_RIGHT]) {
+        /* Pan forward a tenth of a screen */
+        _setView(_level, _viewRow + std::max<size_t>(getTimeWidth() / 10, 1));
+        return;
+    } else if (state[SDL_SCANCODE_PAGEUP]) {
+        /* Pan back one screen */
+        _setView(_level, (_viewRow > getTimeWidth()) ? _viewRow - getTimeWidth() : 0);
+        return;
+    } else if (state[SDL_SCANCODE_PAGEDOWN]) {
+        /* Pan forward one screen */
+        _setView(_level, _viewRow + getTimeWidth());
+        return;
+    } else if (state[SDL_SCANCODE_HOME]) {
+        /* Jump to start */
+        _setView(_level, 0);
+        return;
+    } else if (state[SDL_SCANCODE_END]) {
+        /* Jump to end */
+        _setView(_level, _getRows(_level));
+        return;
+    } else if (state[SDL_SCANCODE_S]) {
+        /* Hide info */
+        _hideSettings = !_hideSettings;
+        if (!_hideSettings)
+            _renderSettings();
+        return;
+    } else if (state[SDL_SCANCODE_D]) {
+        /* Hide statistics */
+        _hideStatistics = !_hideStatistics;
+        if (!_hideStatistics)
+            _renderStatistics();
+        return;
+    } else if (state[SDL_SCANCODE_H]) {
+        /* Hide help */
+        _hideHelp = !_hideHelp;
+        if (!_hideHelp)
+            _renderHelp();
+        return;
+    } else if (state[SDL_SCANCODE_F]) {
+        _fullscreen = !_fullscreen;
+        if (_fullscreen) {
+            if (SDL_SetWindowFullscreen(_win, SDL_WINDOW_FULLSCREEN_DESKTOP) < 0)
+                throw SDLException("Setting fullscreen on SDL window: SDL_SetWindowFullscreen(): " + std::string(SDL_GetError()));
+        } else {
+            if (SDL_SetWindowFullscreen(_win, 0) < 0)
+                throw SDLException("Clearing fullscreen on SDL window: SDL_SetWindowFullscreen(): " + std::string(SDL_GetError()));
+        }
+        return;
+    } else {
+        return;
+    }
+
+    /* Recolor with new spectrum renderer settings */
+    _renderPixels();
+    _renderSettings();
+}
+
+void ViewerThread::run() {
+    auto statisticsTic = std::chrono::system_clock::now();
+
+    /* Request and render initial view */
+    _setView(_level, 0);
+    /* Render settings */
+    _renderSettings();
+    /* Render statistics */
+    _renderStatistics();
+
+    _running = true;
+
+    while (_running) {
+        /* Handle SDL events */
+        SDL_Event e;
+        if (SDL_PollEvent(&e)) {
+            if (e.type == SDL_QUIT) {
+                _running = false;
+            } else if (e.type == SDL_KEYDOWN) {
+                const uint8_t *state = SDL_GetKeyboardState(nullptr);
+                _handleKeyDown(state);
+            } else if (e.type == SDL_MOUSEWHEEL) {
+                /* Zoom at cursor */
+                int mx, my;
+                SDL_GetMouseState(&mx, &my);
+                _zoom(e.wheel.y, static_cast<unsigned int>(std::max((_orientation == Orientation::Vertical) ? my : mx, 0)));
+            } else if (e.type == SDL_MOUSEMOTION) {
+                /* Pan while dragging */
+                if (e.motion.state & SDL_BUTTON_LMASK) {
+                    long rows = -static_cast<long>((_orientation == Orientation::Vertical) ? e.motion.yrel : e.motion.xrel);
+                    if (rows < 0)
+                        _setView(_level, (_viewRow > static_cast<size_t>(-rows)) ? _viewRow - static_cast<size_t>(-rows) : 0);
+                    else if (rows > 0)
+                        _setView(_level, _viewRow + static_cast<size_t>(rows));
+                }
+
+                _renderCursor(e.motion.x, e.motion.y);
+            } else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_RESIZED) {
+                _width = static_cast<unsigned int>(e.window.data1);
+                _height = static_cast<unsigned int>(e.window.data2);
+
+                /* Resize and re-initialize pixel buffer */
+                _pixels.resize(_width * _height);
+                std::fill(_pixels.begin(), _pixels.end(), 0);
+
+                /* Flush tiles of the old spectrum width */
+                {
+                    std::lock_guard<std::mutex> tilesLg(_tilesLock);
+                    _threadPool.clear();
+                    _queuedTiles.clear();
+                    _tileCache.clear();
+                    _tileWidth = getSpectrumWidth();
+                }
+
+                /* Resize pixels texture */
+                if (_pixelsTexture)
+                    SDL_DestroyTexture(_pixelsTexture);
+
+                _pixelsTexture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STATIC, static_cast<int>(getSpectrumWidth()), static_cast<int>(getTimeWidth()));
+                if (_pixelsTexture == nullptr)
+                    throw SDLException("Creating SDL texture: SDL_CreateTexture(): " + std::string(SDL_GetError()));
+
+                /* Re-request view, zooming out if the file now fits at a lower level */
+                _setView(std::min(_level, _getMaxLevel()), _viewRow);
+
+                /* Re-render cursor */
+                int mx, my;
+                SDL_GetMouseState(&mx, &my);
+                _renderCursor(mx, my);
+
+                /* Re-render statistics */
+                if (!_hideStatistics)
+                    _renderStatistics();
+
+                /* Re-render help */
+                if (!_hideHelp)
+                    _renderHelp();
+            }
+        }
+
+        /* Update statistics every 500ms */
+        if (!_hideStatistics && (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - statisticsTic).count() > 500)) {
+            _renderStatistics();
+            statisticsTic = std::chrono::system_clock::now();
+        }
+
+        /* Recolor view when new tiles arrive, or stop on a failed tile */
+        if (_tilesUpdated.exchange(false)) {
+            {
+                std::lock_guard<std::mutex> tilesLg(_tilesLock);
+                if (_tileException)
+                    std::rethrow_exception(_tileException);
+            }
+
+            _renderPixels();
+        }
+
+        SDL_RenderClear(_renderer);
+
+        /* Render pixels */
+        if (_orientation == Orientation::Vertical)
+            SDL_RenderCopy(_renderer, _pixelsTexture, nullptr, nullptr);
+        else {
+            SDL_Rect destRect = {(static_cast<int>(_width) - static_cast<int>(_height)) / 2, -(static_cast<int>(_width) - static_cast<int>(_height)) / 2, static_cast<int>(_height), static_cast<int>(_width)};
+            SDL_RenderCopyEx(_renderer, _pixelsTexture, nullptr, &destRect, 90, nullptr, static_cast<SDL_RendererFlip>(SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL));
+        }
+
+        /* Render settings and cursor */
+        if (!_hideSettings) {
+            SDL_RenderCopy(_renderer, _settingsTexture, nullptr, &_settingsRect);
+            SDL_RenderCopy(_renderer, _cursorTexture, nullptr, &_cursorRect);
+        }
+
+        /* Render statistics */
+        if (!_hideStatistics) {
+            SDL_RenderCopy(_renderer, _statisticsTexture, nullptr, &_statisticsRect);
+        }
+
+        /* Render help */
+        if (!_hideHelp) {
+            SDL_RenderCopy(_renderer, _helpTexture, nullptr, &_helpRect);
+        }
+
+        SDL_RenderPresent(_renderer);
+
+        SDL_Delay(5);
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+#include <exception>
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "InterfaceHelpers.hpp"
+#include "ThreadPool.hpp"
+#include "audio/WaveAudioSource.hpp"
+#include "dft/RealDft.hpp"
+#include "spectrogram/SpectrumRenderer.hpp"
+#include "spectrogram/TileCache.hpp"
+#include "Configuration.hpp"
+
+class ViewerThread {
+  public:
+    ViewerThread(std::string audioPath, const Configuration::Settings &initialSettings);
+    ~ViewerThread();
+
+    void run();
+
+  private:
+    inline unsigned int getSpectrumWidth() { return (_orientation == Configuration::Orientation::Vertical) ? _width : _height; }
+    inline unsigned int getTimeWidth() { return (_orientation == Configuration::Orientation::Vertical) ? _height : _width; }
+
+    /* Audio file */
+    const std::string _audioPath;
+    unsigned int _sampleRate;
+    size_t _length;
+
+    /* DFT settings */
+    const unsigned int _dftSize;
+    const DFT::RealDft::WindowFunction _dftWindowFunction;
+    size_t _samplesHop;
+
+    /* Running boolean */
+    bool _running;
+
+    /* Spectrum renderer for coloring magnitudes */
+    Spectrogram::SpectrumRenderer _spectrumRenderer;
+    /* Colored pixels of visible rows */
+    std::vector<uint32_t> _pixels;
+
+    /* Tiles of quantized magnitudes, keyed by zoom level and tile index */
+    Spectrogram::TileCache _tileCache;
+    std::unordered_set<uint64_t> _queuedTiles;
+    std::unordered_set<uint64_t> _runningTiles;
+    /* Tiles whose computation failed, never resubmitted, and the first failure */
+    std::unordered_set<uint64_t> _failedTiles;
+    std::exception_ptr _tileException;
+    unsigned int _tileWidth;
+    std::mutex _tilesLock;
+    std::atomic<bool> _tilesUpdated;
+
+    /* Tile computation workers */
+    struct Worker {
+        std::unique_ptr<Audio::WaveAudioSource> audioSource;
+        std::unique_ptr<DFT::RealDft> realDft;
+        std::vector<float> samples;
+        std::vector<float> newSamples;
+        std::vector<std::complex<float>> dft;
+        std::vector<uint16_t> magnitudes;
+    };
+    std::vector<Worker> _workers;
+    ThreadPool _threadPool;
+
+    /* View position: zoom level (samples per row = hop << level), first visible row, pan direction */
+    unsigned int _level;
+    size_t _viewRow = 0;
+    int _panDirection = 1;
+
+    /* Owned resources (SDL) */
+    SDL_Window *_win = nullptr;
+    SDL_Renderer *_renderer = nullptr;
+    SDL_Texture *_pixelsTexture = nullptr;
+    SDL_Texture *_settingsTexture = nullptr;
+    SDL_Texture *_cursorTexture = nullptr;
+    SDL_Texture *_statisticsTexture = nullptr;
+    SDL_Texture *_helpTexture = nullptr;
+    SDL_Rect _settingsRect;
+    SDL_Rect _cursorRect;
+    SDL_Rect _statisticsRect;
+    SDL_Rect _helpRect;
+    TTF_Font *_font = nullptr;
+
+    /* Interface settings */
+    bool _fullscreen;
+    unsigned int _width, _height;
+    const Configuration::Orientation _orientation;
+    bool _hideSettings = false;
+    bool _hideStatistics = true;
+    bool _hideHelp = true;
+
+    /* View helper functions */
+    size_t _getSamplesPerRow(unsigned int level);
+    size_t _getRows(unsigned int level);
+    unsigned int _getMaxLevel();
+    void _setView(unsigned int level, size_t row);
+    void _zoom(int direction, unsigned int timePosition);
+
+    /* Tile helper functions */
+    void _requestTiles();
+    void _computeTile(unsigned int worker, uint64_t key, unsigned int level, size_t index, unsigned int width);
+
+    /* Helper functions for SDL */
+    void _handleKeyDown(const uint8_t *state);
+    void _renderPixels();
+    void _renderSettings();
+    void _renderCursor(int x, int y);
+    void _renderStatistics();
+    void _renderHelp();
+};
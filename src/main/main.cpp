@@ -1,24 +1,53 @@
 #include <iostream>
+#include <sstream>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <mutex>
+#include <map>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
 #include <getopt.h>
+#include <dirent.h>
+#include <strings.h>
+#include <sys/stat.h>
 
 #include "audio/PulseAudioSource.hpp"
 #include "dft/RealDft.hpp"
+#include "dft/ConstantQTransform.hpp"
+#include "dft/SlidingDft.hpp"
+#include "dft/GoertzelBank.hpp"
+#include "dft/MultitaperDft.hpp"
+#include "dft/PolyphaseFilterbank.hpp"
 #include "spectrogram/SpectrumRenderer.hpp"
+#include "spectrogram/FrequencyAxis.hpp"
+#include "spectrogram/MagnitudeRange.hpp"
 
 #include "audio/WaveAudioSource.hpp"
+#include "audio/RawAudioSource.hpp"
 #include "image/MagickImageSink.hpp"
+#include "image/Y4mVideoSink.hpp"
+#include "cache/MagnitudeCacheWriter.hpp"
+#include "cache/MagnitudeCacheReader.hpp"
+#include "cache/NpyMagnitudeWriter.hpp"
 
 #include "ThreadSafeQueue.hpp"
+#include "ThreadPool.hpp"
 
 #include "AudioThread.hpp"
 #include "SpectrogramThread.hpp"
 #include "InterfaceThread.hpp"
+#include "ViewerThread.hpp"
+#include "MosaicThread.hpp"
+#include "PyramidWriter.hpp"
 #include "Configuration.hpp"
 
 using namespace Audio;
 using namespace DFT;
 using namespace Spectrogram;
 using namespace Image;
+using namespace Cache;
 
 namespace Configuration {
 Settings InitialSettings;
@@ -27,13 +56,19 @@ Limits UserLimits;
 
 using namespace Configuration;
 
+/* Time range outside of the input, reported as a usage error */
+class RangeException : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
 void spectrogram_realtime() {
     ThreadSafeQueue<std::vector<float>> samplesQueue;
-    ThreadSafeQueue<std::vector<uint32_t>> pixelsQueue;
+    ThreadSafeQueue<std::vector<uint16_t>> magnitudesQueue;
 
-    AudioThread audioThread(samplesQueue, InitialSettings);
-    SpectrogramThread spectrogramThread(samplesQueue, pixelsQueue, InitialSettings);
-    InterfaceThread interfaceThread(pixelsQueue, audioThread, spectrogramThread, InitialSettings);
+    AudioThread audioThread(samplesQueue, InitialSettings, InitialSettings.audioSources.empty() ? "" : InitialSettings.audioSources[0].device);
+    SpectrogramThread spectrogramThread(samplesQueue, magnitudesQueue, InitialSettings);
+    InterfaceThread interfaceThread(magnitudesQueue, audioThread, spectrogramThread, InitialSettings);
 
     audioThread.start();
     spectrogramThread.start();
@@ -43,57 +78,447 @@ void spectrogram_realtime() {
     audioThread.stop();
 }
 
-void spectrogram_audiofile(std::string audioPath, std::string imagePath) {
+void spectrogram_mosaic() {
+    MosaicThread mosaicThread(InitialSettings);
+
+    mosaicThread.run();
+}
+
+void spectrogram_viewer(std::string audioPath) {
+    ViewerThread viewerThread(audioPath, InitialSettings);
+
+    viewerThread.run();
+}
+
+void set_magnitude_range(SpectrumRenderer &spectrumRenderer, MagnitudeRange &magnitudeRange) {
+    float magnitudeMin, magnitudeMax;
+    magnitudeRange.getRange(magnitudeMin, magnitudeMax);
+
+    if (!InitialSettings.magnitudeLog) {
+        magnitudeMin = std::pow(10.0f, magnitudeMin / 20.0f);
+        magnitudeMax = std::pow(10.0f, magnitudeMax / 20.0f);
+    }
+
+    spectrumRenderer.setMagnitudeRange(magnitudeMin, magnitudeMax);
+}
+
+void spectrogram_audiofile(std::string audioPath, std::string imagePath, std::string cachePath, std::string pyramidPath, std::string npyPath, std::string videoPath) {
     unsigned int spectrumWidth = (InitialSettings.orientation == Orientation::Vertical) ? InitialSettings.width : InitialSettings.height;
+    unsigned int timeWidth = (InitialSettings.orientation == Orientation::Vertical) ? InitialSettings.height : InitialSettings.width;
+    MagickImageSink::Orientation imageOrientation = (InitialSettings.orientation == Orientation::Vertical) ? MagickImageSink::Orientation::Vertical : MagickImageSink::Orientation::Horizontal;
+    Y4mVideoSink::Orientation videoOrientation = (InitialSettings.orientation == Orientation::Vertical) ? Y4mVideoSink::Orientation::Vertical : Y4mVideoSink::Orientation::Horizontal;
+
+    /* WAV file, or raw PCM stream */
+    std::unique_ptr<WaveAudioSource> waveAudioSource;
+    std::unique_ptr<RawAudioSource> rawAudioSource;
+    if (InitialSettings.audioRaw)
+        rawAudioSource.reset(new RawAudioSource(audioPath, InitialSettings.audioRawFormat, InitialSettings.audioSampleRate, InitialSettings.audioChannels));
+    else
+        waveAudioSource.reset(new WaveAudioSource(audioPath));
+    AudioSource &audioSource = rawAudioSource ? static_cast<AudioSource &>(*rawAudioSource) : static_cast<AudioSource &>(*waveAudioSource);
+
+    /* Time range in samples, to the end of the input with no duration, validated before any output is created */
+    size_t startSample = static_cast<size_t>(static_cast<double>(InitialSettings.audioStart) * audioSource.getSampleRate());
+    size_t durationSamples = (InitialSettings.audioDuration > 0) ? static_cast<size_t>(static_cast<double>(InitialSettings.audioDuration) * audioSource.getSampleRate()) : SIZE_MAX;
+    if (durationSamples < 1)
+        throw RangeException("Invalid value for duration (must be at least one sample, " + std::to_string(1.0 / audioSource.getSampleRate()) + " seconds).");
+    if (waveAudioSource && startSample >= waveAudioSource->getLength())
+        throw RangeException("Invalid value for start (must be before the end of the WAV file, " + std::to_string(static_cast<double>(waveAudioSource->getLength()) / audioSource.getSampleRate()) + " seconds).");
 
-    WaveAudioSource audioSource(audioPath);
-    RealDft realDft(InitialSettings.dftSize, InitialSettings.dftWindowFunction);
     SpectrumRenderer spectrumRenderer(InitialSettings.magnitudeMin, InitialSettings.magnitudeMax, InitialSettings.magnitudeLog, InitialSettings.colorScheme);
-    MagickImageSink image(imagePath, spectrumWidth, (InitialSettings.orientation == Orientation::Vertical) ? MagickImageSink::Orientation::Vertical : MagickImageSink::Orientation::Horizontal);
+    FrequencyAxis frequencyAxis(InitialSettings.frequencyScale);
+    SpectrumAverager spectrumAverager(InitialSettings.averageMode, InitialSettings.averageAlpha, InitialSettings.averageFrames);
 
     unsigned int samplesOverlap = static_cast<unsigned int>(InitialSettings.samplesOverlap * static_cast<float>(InitialSettings.dftSize));
 
+    /* Plan large DFTs with multiple threads */
+    RealDft::setPlannerThreads((InitialSettings.fftThreads == 0) ? ThreadPool::defaultThreads() : InitialSettings.fftThreads);
+
+    /* Spectrum engine */
+    std::unique_ptr<SpectrumEngine> engine;
+    if (InitialSettings.dftEngine == SpectrumEngine::Type::ConstantQ) {
+        engine.reset(new ConstantQTransform(InitialSettings.dftSize, InitialSettings.dftWindowFunction, audioSource.getSampleRate(), InitialSettings.cqtBinsPerOctave, InitialSettings.cqtMinFrequency));
+    } else if (InitialSettings.dftEngine == SpectrumEngine::Type::SlidingDft) {
+        SlidingDft *slidingDft = new SlidingDft(InitialSettings.dftSize, InitialSettings.dftWindowFunction);
+        slidingDft->setHop(InitialSettings.dftSize - samplesOverlap);
+        engine.reset(slidingDft);
+    } else if (InitialSettings.dftEngine == SpectrumEngine::Type::Polyphase) {
+        PolyphaseFilterbank *polyphaseFilterbank = new PolyphaseFilterbank(InitialSettings.dftSize, InitialSettings.dftWindowFunction, InitialSettings.pfbTaps);
+        polyphaseFilterbank->setHop(InitialSettings.dftSize - samplesOverlap);
+        engine.reset(polyphaseFilterbank);
+    } else if (InitialSettings.dftEngine == SpectrumEngine::Type::Multitaper) {
+        engine.reset(new MultitaperDft(InitialSettings.dftSize, InitialSettings.multitaperTapers));
+    } else if (InitialSettings.dftEngine == SpectrumEngine::Type::Goertzel) {
+        engine.reset(new GoertzelBank(InitialSettings.dftSize, InitialSettings.dftWindowFunction, audioSource.getSampleRate(), InitialSettings.goertzelFrequencies));
+    } else {
+        engine.reset(new RealDft(InitialSettings.dftSize, InitialSettings.dftWindowFunction));
+    }
+
+    /* Optional image */
+    std::unique_ptr<MagickImageSink> image;
+    if (imagePath != "")
+        image.reset(new MagickImageSink(imagePath, spectrumWidth, imageOrientation));
+
+    /* Optional magnitude cache */
+    std::unique_ptr<MagnitudeCacheWriter> cache;
+    if (cachePath != "")
+        cache.reset(new MagnitudeCacheWriter(cachePath, audioSource.getSampleRate(), InitialSettings.dftSize, InitialSettings.dftWindowFunction, samplesOverlap));
+
+    /* Optional pyramid */
+    std::unique_ptr<PyramidWriter> pyramid;
+    if (pyramidPath != "")
+        pyramid.reset(new PyramidWriter(pyramidPath, spectrumWidth, static_cast<float>(InitialSettings.dftSize - samplesOverlap) / static_cast<float>(audioSource.getSampleRate()), imageOrientation, spectrumRenderer));
+
+    /* Optional video */
+    std::unique_ptr<Y4mVideoSink> video;
+    if (videoPath != "")
+        video.reset(new Y4mVideoSink(videoPath, spectrumWidth, timeWidth, videoOrientation, InitialSettings.videoFps, audioSource.getSampleRate(), InitialSettings.dftSize - samplesOverlap));
+
+    /* Optional NPY spectrum output, with the row count known up front for WAV files */
+    std::unique_ptr<NpyMagnitudeWriter> npy;
+    if (npyPath != "") {
+        size_t hop = InitialSettings.dftSize - samplesOverlap;
+        size_t bins = InitialSettings.dftSize / 2 + 1;
+        if (InitialSettings.dftEngine == SpectrumEngine::Type::ConstantQ)
+            bins = static_cast<ConstantQTransform *>(engine.get())->getBins();
+        else if (InitialSettings.dftEngine == SpectrumEngine::Type::Goertzel)
+            bins = InitialSettings.goertzelFrequencies.size();
+
+        uint64_t rows = waveAudioSource ? (std::min(waveAudioSource->getLength() - startSample, durationSamples) + hop - 1) / hop : 0;
+        npy.reset(new NpyMagnitudeWriter(npyPath, InitialSettings.npyFormat, bins, rows, audioSource.getSampleRate(), InitialSettings.dftSize, samplesOverlap));
+    }
+
+    /* Image rows are only needed for an image, pyramid, or video */
+    bool rendering = image || pyramid || video;
+
     /* Overlapped Samples */
     std::vector<float> overlapSamples(InitialSettings.dftSize);
     /* DFT of Overlapped Samples */
     std::vector<std::complex<float>> dftSamples(InitialSettings.dftSize / 2 + 1);
+    /* Quantized magnitudes line */
+    std::vector<uint16_t> magnitudes(spectrumWidth);
     /* Pixel line */
     std::vector<uint32_t> pixels(spectrumWidth);
+    /* Quantized magnitudes of all DFT bins */
+    std::vector<uint16_t> binMagnitudes(InitialSettings.dftSize / 2 + 1);
+    /* New audio samples of each hop, allocated once for large DFT sizes */
+    std::vector<float> audioSamples;
+    audioSamples.reserve(overlapSamples.size() - samplesOverlap);
 
-    while (true) {
-        std::vector<float> audioSamples(overlapSamples.size() - samplesOverlap);
+    /* With auto range, a first pass over the file picks the magnitude range for the second */
+    MagnitudeRange magnitudeRange;
+    for (unsigned int pass = (InitialSettings.magnitudeAuto && rendering) ? 0 : 1; pass < 2; pass++) {
+        bool ranging = (pass == 0);
 
-        /* Read audio samples */
-        audioSource.read(audioSamples);
-        if (audioSamples.size() == 0)
-            break;
+        /* Restart at the start of the range, with the samples overlap before it as lead-in */
+        size_t leadIn = std::min<size_t>(startSample, samplesOverlap);
+        std::fill(overlapSamples.begin(), overlapSamples.end(), 0.0f);
+        spectrumAverager.reset();
+
+        if (waveAudioSource) {
+            waveAudioSource->seek(startSample - leadIn);
+        } else {
+            /* Raw streams are read in one pass, and skipped by reading */
+            for (size_t skip = startSample - leadIn; skip > 0; skip -= audioSamples.size()) {
+                audioSamples.resize(std::min(skip, overlapSamples.size()));
+                audioSource.read(audioSamples);
+                if (audioSamples.size() == 0)
+                    throw RangeException("Invalid value for start (must be before the end of the raw input).");
+            }
+        }
+
+        if (leadIn > 0) {
+            audioSamples.resize(leadIn);
+            audioSource.read(audioSamples);
+            memcpy(overlapSamples.data() + (overlapSamples.size() - audioSamples.size()), audioSamples.data(), sizeof(float) * audioSamples.size());
+        }
+
+        size_t remainingSamples = durationSamples;
 
-        /* If we're on the final read and short on samples, pad with zeros */
-        if (audioSamples.size() < (overlapSamples.size() - samplesOverlap))
-            audioSamples.resize(overlapSamples.size() - samplesOverlap);
+        while (true) {
+            audioSamples.resize(std::min(overlapSamples.size() - samplesOverlap, remainingSamples));
 
-        /* Move down overlapSamples.size()-samplesOverlap length old samples */
-        memmove(overlapSamples.data(), overlapSamples.data() + samplesOverlap, sizeof(float) * (overlapSamples.size() - samplesOverlap));
-        /* Copy overlapSamples.size()-samplesOverlap length new samples */
-        memcpy(overlapSamples.data() + samplesOverlap, audioSamples.data(), sizeof(float) * (overlapSamples.size() - samplesOverlap));
+            /* Read audio samples, up to the end of the range */
+            audioSource.read(audioSamples);
+            if (audioSamples.size() == 0)
+                break;
+            remainingSamples -= audioSamples.size();
 
-        /* Compute DFT */
-        realDft.compute(dftSamples, overlapSamples);
+            /* If we're on the final read and short on samples, pad with zeros */
+            if (audioSamples.size() < (overlapSamples.size() - samplesOverlap))
+                audioSamples.resize(overlapSamples.size() - samplesOverlap);
 
-        /* Render spectrogram line */
-        spectrumRenderer.render(pixels, dftSamples);
+            /* Move down samplesOverlap length old samples */
+            memmove(overlapSamples.data(), overlapSamples.data() + (overlapSamples.size() - samplesOverlap), sizeof(float) * samplesOverlap);
+            /* Copy overlapSamples.size()-samplesOverlap length new samples */
+            memcpy(overlapSamples.data() + samplesOverlap, audioSamples.data(), sizeof(float) * (overlapSamples.size() - samplesOverlap));
 
-        /* Add pixel row to image */
-        image.append(pixels);
+            /* Compute spectrum */
+            engine->compute(dftSamples, overlapSamples);
+
+            /* Add DFT magnitudes to cache */
+            if (cache && !ranging) {
+                SpectrumRenderer::quantize(binMagnitudes, dftSamples);
+                cache->append(binMagnitudes);
+            }
+
+            /* Average spectrum in power, after caching so the cache holds unaveraged DFTs */
+            spectrumAverager.process(dftSamples);
+
+            /* Add spectrum row to NPY output */
+            if (npy && !ranging)
+                npy->append(dftSamples);
+
+            if (!rendering)
+                continue;
+
+            /* Quantize spectrogram line, linearly across constant-Q bins or Goertzel tones */
+            if (InitialSettings.dftEngine == SpectrumEngine::Type::ConstantQ || InitialSettings.dftEngine == SpectrumEngine::Type::Goertzel)
+                SpectrumRenderer::quantize(magnitudes, dftSamples);
+            else
+                frequencyAxis.quantize(magnitudes, dftSamples, audioSource.getSampleRate());
+
+            /* Count magnitudes for the range on the first pass */
+            if (ranging) {
+                magnitudeRange.append(magnitudes.data(), magnitudes.size());
+                continue;
+            }
+
+            /* Add magnitudes row to pyramid */
+            if (pyramid)
+                pyramid->append(magnitudes);
+
+            /* Render spectrogram line and add pixel row to image and video */
+            if (image || video) {
+                spectrumRenderer.render(pixels.data(), magnitudes.data(), pixels.size());
+                if (image)
+                    image->append(pixels);
+                if (video)
+                    video->append(pixels);
+            }
+        }
+
+        if (ranging)
+            set_magnitude_range(spectrumRenderer, magnitudeRange);
     }
 
-    image.write();
+    if (cache)
+        cache->write();
+
+    if (npy)
+        npy->write();
+
+    if (video)
+        video->write();
+
+    if (pyramid)
+        pyramid->write();
+
+    if (image)
+        image->write();
+}
+
+void spectrogram_cachefile(std::string cachePath, std::string imagePath, std::string pyramidPath, std::string videoPath) {
+    unsigned int spectrumWidth = (InitialSettings.orientation == Orientation::Vertical) ? InitialSettings.width : InitialSettings.height;
+    unsigned int timeWidth = (InitialSettings.orientation == Orientation::Vertical) ? InitialSettings.height : InitialSettings.width;
+    MagickImageSink::Orientation imageOrientation = (InitialSettings.orientation == Orientation::Vertical) ? MagickImageSink::Orientation::Vertical : MagickImageSink::Orientation::Horizontal;
+    Y4mVideoSink::Orientation videoOrientation = (InitialSettings.orientation == Orientation::Vertical) ? Y4mVideoSink::Orientation::Vertical : Y4mVideoSink::Orientation::Horizontal;
+
+    MagnitudeCacheReader cache(cachePath);
+    SpectrumRenderer spectrumRenderer(InitialSettings.magnitudeMin, InitialSettings.magnitudeMax, InitialSettings.magnitudeLog, InitialSettings.colorScheme);
+    FrequencyAxis frequencyAxis(InitialSettings.frequencyScale);
+
+    /* Optional image */
+    std::unique_ptr<MagickImageSink> image;
+    if (imagePath != "")
+        image.reset(new MagickImageSink(imagePath, spectrumWidth, imageOrientation));
+
+    /* Optional pyramid */
+    std::unique_ptr<PyramidWriter> pyramid;
+    if (pyramidPath != "")
+        pyramid.reset(new PyramidWriter(pyramidPath, spectrumWidth, static_cast<float>(cache.getDftSize() - cache.getSamplesOverlap()) / static_cast<float>(cache.getSampleRate()), imageOrientation, spectrumRenderer));
+
+    /* Optional video */
+    std::unique_ptr<Y4mVideoSink> video;
+    if (videoPath != "")
+        video.reset(new Y4mVideoSink(videoPath, spectrumWidth, timeWidth, videoOrientation, InitialSettings.videoFps, cache.getSampleRate(), cache.getDftSize() - cache.getSamplesOverlap()));
+
+    /* Quantized magnitudes line */
+    std::vector<uint16_t> magnitudes(spectrumWidth);
+    /* Pixel line */
+    std::vector<uint32_t> pixels(spectrumWidth);
+
+    /* With auto range, a first pass over the cache picks the magnitude range */
+    if (InitialSettings.magnitudeAuto) {
+        MagnitudeRange magnitudeRange;
+
+        for (size_t i = 0; i < cache.getFrames(); i++) {
+            frequencyAxis.resample(magnitudes, cache.getFrame(i), cache.getBins(), cache.getSampleRate());
+            magnitudeRange.append(magnitudes.data(), magnitudes.size());
+        }
+
+        set_magnitude_range(spectrumRenderer, magnitudeRange);
+    }
+
+    for (size_t i = 0; i < cache.getFrames(); i++) {
+        /* Resample cached DFT magnitudes to spectrum width */
+        frequencyAxis.resample(magnitudes, cache.getFrame(i), cache.getBins(), cache.getSampleRate());
+
+        /* Add magnitudes row to pyramid */
+        if (pyramid)
+            pyramid->append(magnitudes);
+
+        /* Render spectrogram line and add pixel row to image and video */
+        if (image || video) {
+            spectrumRenderer.render(pixels.data(), magnitudes.data(), pixels.size());
+            if (image)
+                image->append(pixels);
+            if (video)
+                video->append(pixels);
+        }
+    }
+
+    if (video)
+        video->write();
+
+    if (pyramid)
+        pyramid->write();
+
+    if (image)
+        image->write();
+}
+
+bool list_audio_files(const std::string &path, std::vector<std::string> &audioPaths) {
+    struct stat st;
+    if (stat(path.c_str(), &st) < 0) {
+        std::cerr << "Error opening " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    /* Input is a single file */
+    if (!S_ISDIR(st.st_mode)) {
+        audioPaths.push_back(path);
+        return true;
+    }
+
+    /* Input is a directory of WAV files, taken in name order */
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        std::cerr << "Error opening directory " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> names;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0)
+            names.push_back(name);
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+    for (const std::string &name : names)
+        audioPaths.push_back(path + "/" + name);
+
+    return true;
+}
+
+bool spectrogram_batch(std::vector<std::string> inputPaths, std::string outputPath, unsigned int jobs) {
+    /* Expand input directories */
+    std::vector<std::string> audioPaths;
+    for (const std::string &inputPath : inputPaths) {
+        if (!list_audio_files(inputPath, audioPaths))
+            return false;
+    }
+
+    /* Image paths, named after the audio files */
+    std::vector<std::string> imagePaths;
+    for (const std::string &audioPath : audioPaths) {
+        std::string name = audioPath.substr(audioPath.find_last_of('/') + 1);
+        size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos && dot > 0)
+            name = name.substr(0, dot);
+
+        imagePaths.push_back(outputPath + "/" + name + ".png");
+    }
+
+    /* Files of the same name in different directories would overwrite each other's images */
+    std::map<std::string, size_t> imageSources;
+    bool unique = true;
+    for (size_t i = 0; i < imagePaths.size(); i++) {
+        auto it = imageSources.emplace(imagePaths[i], i);
+        if (!it.second) {
+            std::cerr << "Error: " << audioPaths[i] << " and " << audioPaths[it.first->second] << " would both be rendered to " << imagePaths[i] << "." << std::endl;
+            unique = false;
+        }
+    }
+    if (!unique)
+        return false;
+
+    if (mkdir(outputPath.c_str(), 0755) < 0 && errno != EEXIST) {
+        std::cerr << "Error creating output directory " << outputPath << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    /* Progress, reported in input order as files complete */
+    std::mutex progressLock;
+    std::vector<bool> done(audioPaths.size(), false);
+    std::vector<std::string> errors(audioPaths.size());
+    size_t reported = 0;
+    bool success = true;
+
+    /* Files share the process's FFTW wisdom and GraphicsMagick initialization */
+    ThreadPool threadPool((jobs == 0) ? ThreadPool::defaultThreads() : jobs);
+
+    for (size_t i = 0; i < audioPaths.size(); i++) {
+        threadPool.submit([&, i](unsigned int) {
+            std::string error;
+
+            try {
+                spectrogram_audiofile(audioPaths[i], imagePaths[i], "", "", "", "");
+            } catch (const std::exception &e) {
+                error = e.what();
+            }
+
+            std::lock_guard<std::mutex> lg(progressLock);
+            done[i] = true;
+            errors[i] = error;
+
+            for (; reported < audioPaths.size() && done[reported]; reported++) {
+                if (errors[reported] == "") {
+                    std::cout << "[" << (reported + 1) << "/" << audioPaths.size() << "] " << audioPaths[reported] << " -> " << imagePaths[reported] << std::endl;
+                } else {
+                    std::cerr << "[" << (reported + 1) << "/" << audioPaths.size() << "] " << audioPaths[reported] << ": " << errors[reported] << std::endl;
+                    success = false;
+                }
+            }
+        });
+    }
+
+    threadPool.wait();
+
+    return success;
 }
 
 void print_usage(std::string progname) {
     std::cerr << "Real-time Usage: " << progname << " [options]\n"
-                                                    " WAV File Usage: "
+                                                    " WAV Viewer Usage: "
+              << progname << " [options] <WAV file input>\n"
+                             " WAV File Usage: "
               << progname << " [options] <WAV file input> <image file output>\n"
+                             " Cache Usage: "
+              << progname << " [options] <magnitude cache input> <image file output>\n"
+                             " Pyramid Usage: "
+              << progname << " [options] --pyramid <name> <WAV file or magnitude cache input>\n"
+                             " NPY Usage: "
+              << progname << " [options] --npy <NPY file output> <WAV file input>\n"
+                             " Video Usage: "
+              << progname << " [options] --video <Y4M file output> <WAV file or magnitude cache input>\n"
+                             " Batch Usage: "
+              << progname << " [options] --batch <directory> <WAV files or directories...>\n"
+                             " Raw PCM Usage: "
+              << progname << " [options] --raw <format> <raw input> [image file output]\n"
                              "\n"
                              "Interface Settings\n"
                              "    -h,--help                   Help\n"
@@ -102,23 +527,75 @@ void print_usage(std::string progname) {
                              "    --height <height>           Height of spectrogram (default 480)\n"
                              "    --orientation <orientation> Orientation [horizontal, vertical]\n"
                              "                                    (default vertical)\n"
+                             "    --history <seconds>         Scrollback history duration (default 1800)\n"
                              "\n"
                              "Audio Settings\n"
                              "    -r,--sample-rate <rate>     Audio input sample rate (default 24000)\n"
+                             "    --source <name>[@<rate>]    PulseAudio source device, repeat for a tiled\n"
+                             "                                    mosaic of sources (default source)\n"
+                             "    --raw <format>              Read input as raw PCM [s16, f32], - for stdin\n"
+                             "    --channels <channels>       Raw PCM input channels (default 1)\n"
                              "\n"
                              "DFT Settings\n"
                              "    --overlap <percentage>      Samples overlap percentage (default 50)\n"
-                             "    --dft-size <size>           DFT Size, must be power of two (default 1024)\n"
+                             "    --hop <samples>             Samples hop between frames, overrides overlap\n"
+                             "    --dft-size <size>           DFT Size, must be power of two, up to 8192 in\n"
+                             "                                    real-time and 1048576 in WAV file mode\n"
+                             "                                    (default 1024)\n"
+                             "    --dft-threads <threads>     Real-time DFT worker threads, 0 for one per core\n"
+                             "                                    (default 0)\n"
+                             "    --fft-threads <threads>     FFTW threads for DFT sizes of 65536 and up,\n"
+                             "                                    0 for one per core (default 0)\n"
                              "    --window <window function>  Window Function [hann, hamming, bartlett, rectangular]\n"
                              "                                    (default hann)\n"
+                             "    --engine <engine>           Spectrum Engine [dft, pfb, cqt, sdft,\n"
+                             "                                    goertzel, multitaper] (default dft)\n"
+                             "    --pfb-taps <taps>           Polyphase filterbank taps per branch, 2 to 16\n"
+                             "                                    (default 4)\n"
+                             "    --cqt-bins <bins>           Constant-Q bins per octave, 12 to 48 (default 24)\n"
+                             "    --cqt-min-frequency <Hz>    Constant-Q lowest frequency (default 32.7)\n"
+                             "    --tones <Hz,Hz,...>         Goertzel tone frequencies\n"
+                             "    --tapers <tapers>           Multitaper number of tapers, 2 to 15 (default 7)\n"
+                             "    --average <mode>            Averaging [none, exponential, boxcar, peak]\n"
+                             "                                    (default none)\n"
+                             "    --average-alpha <alpha>     Exponential weight and peak hold release,\n"
+                             "                                    0.0 to 1.0 (default 0.25)\n"
+                             "    --average-frames <frames>   Boxcar averaging frames, 1 to 64 (default 8)\n"
+                             "\n"
+                             "Zoom Settings (real-time)\n"
+                             "    --zoom <decimation>         Zoom decimation, 1 is off (default 1)\n"
+                             "    --zoom-frequency <Hz>       Zoom center frequency (default 0)\n"
+                             "\n"
+                             "Frame Ring Settings (real-time)\n"
+                             "    --shm <name>                Publish magnitude rows to shared memory ring\n"
+                             "    --shm-slots <slots>         Shared memory ring slots, 2 to 4096 (default 256)\n"
+                             "    --shm-replace               Replace an existing shared memory ring of the same name\n"
+                             "\n"
+                             "WAV File Settings\n"
+                             "    --cache <path>              Write magnitude cache for re-rendering\n"
+                             "    --pyramid <name>            Write Deep Zoom (DZI) pyramid of image tiles\n"
+                             "    --npy <path>                Write spectrum frames as NPY array, - for stdout\n"
+                             "    --npy-format <format>       NPY spectrum format [power, magnitude, u16, u8]\n"
+                             "                                    (default power)\n"
+                             "    --video <path>              Write scrolling spectrogram Y4M video, - for stdout\n"
+                             "    --fps <fps>                 Video frame rate (default 30)\n"
+                             "    --start <seconds>           Start of time range to render (default 0)\n"
+                             "    --duration <seconds>        Duration of time range to render, 0 for the\n"
+                             "                                    rest of the input (default 0)\n"
+                             "    --batch <directory>         Render WAV files to PNG images in directory\n"
+                             "    --jobs <jobs>               Batch files rendered concurrently, 0 for one\n"
+                             "                                    per core (default 0)\n"
                              "\n"
                              "Spectrogram Settings\n"
                              "    --magnitude-scale <scale>   Magnitude Scale [linear, logarithmic]\n"
                              "                                    (default logarithmic)\n"
                              "    --magnitude-min <value>     Magnitude Minimum (default 0.0)\n"
                              "    --magnitude-max <value>     Magnitude Maximum (default 50.0)\n"
+                             "    --magnitude-auto            Track magnitude range from noise floor and peak\n"
                              "    --colors <color scheme>     Color Scheme [heat, blue, grayscale]\n"
                              "                                    (default heat)\n"
+                             "    --frequency-scale <scale>   Frequency Axis Scale [linear, logarithmic, mel]\n"
+                             "                                    (default linear)\n"
                              "\n"
                              "Interactive Keyboard Control:\n"
                              "    q         Quit\n"
@@ -132,12 +609,19 @@ void print_usage(std::string progname) {
                              "    c         Cycle color scheme\n"
                              "    w         Cycle window function\n"
                              "    l         Cycle linear/log magnitude\n"
+                             "    a         Cycle frequency axis\n"
+                             "    e         Cycle spectrum engine\n"
+                             "    b         Cycle constant-Q bins/octave\n"
+                             "    t         Cycle multitaper tapers\n"
+                             "    p         Cycle polyphase filterbank taps\n"
+                             "    v         Cycle averaging\n"
                              "\n"
                              "    -         Decrease min magnitude\n"
                              "    =         Increase min magnitude\n"
                              "\n"
                              "    [         Decrease max magnitude\n"
                              "    ]         Increase max magnitude\n"
+                             "    r         Toggle auto magnitude range\n"
                              "\n"
                              "    Left      Decrease DFT size\n"
                              "    Right     Increase DFT size\n"
@@ -145,13 +629,37 @@ void print_usage(std::string progname) {
                              "    Down      Decrease overlap\n"
                              "    Up        Increase overlap\n"
                              "\n"
+                             "    z         Cycle zoom\n"
+                             "    ,         Decrease zoom frequency\n"
+                             "    .         Increase zoom frequency\n"
+                             "    Click     Set zoom frequency\n"
+                             "\n"
+                             "    Space     Pause/resume\n"
+                             "    PgUp      Scroll back in history\n"
+                             "    PgDn      Scroll forward in history\n"
+                             "    Home      Jump to oldest history\n"
+                             "    End       Jump to live\n"
+                             "\n"
+                             "WAV Viewer Keyboard and Mouse Control:\n"
+                             "    i, Wheel  Zoom in (at cursor)\n"
+                             "    o, Wheel  Zoom out (at cursor)\n"
+                             "\n"
+                             "    Up, Drag  Pan back\n"
+                             "    Down      Pan forward\n"
+                             "    PgUp      Pan back one screen\n"
+                             "    PgDn      Pan forward one screen\n"
+                             "    Home      Jump to start\n"
+                             "    End       Jump to end\n"
+                             "\n"
                              "audioprism v1.1.0 - https://github.com/vsergeev/audioprism"
               << std::endl;
 }
 
 int main(int argc, char *argv[]) {
-    unsigned int overlap = 50;
-    bool sampleRateConfigured = false, widthConfigured = false, heightConfigured = false;
+    unsigned int overlap = 50, hop = 0;
+    bool sampleRateConfigured = false, widthConfigured = false, heightConfigured = false, dftConfigured = false, zoomConfigured = false, rangeConfigured = false;
+    unsigned int jobs = 0;
+    std::string cachePath, pyramidPath, npyPath, videoPath, batchPath;
 
     static struct option long_options[] = {
         {"help", no_argument, 0, 'h'},
@@ -159,14 +667,48 @@ int main(int argc, char *argv[]) {
         {"width", required_argument, 0, 0},
         {"height", required_argument, 0, 0},
         {"orientation", required_argument, 0, 0},
+        {"history", required_argument, 0, 0},
         {"sample-rate", required_argument, 0, 'r'},
+        {"source", required_argument, 0, 0},
+        {"raw", required_argument, 0, 0},
+        {"channels", required_argument, 0, 0},
         {"overlap", required_argument, 0, 0},
+        {"hop", required_argument, 0, 0},
         {"dft-size", required_argument, 0, 0},
+        {"dft-threads", required_argument, 0, 0},
+        {"fft-threads", required_argument, 0, 0},
         {"window", required_argument, 0, 0},
+        {"engine", required_argument, 0, 0},
+        {"cqt-bins", required_argument, 0, 0},
+        {"cqt-min-frequency", required_argument, 0, 0},
+        {"tones", required_argument, 0, 0},
+        {"tapers", required_argument, 0, 0},
+        {"pfb-taps", required_argument, 0, 0},
+        {"average", required_argument, 0, 0},
+        {"average-alpha", required_argument, 0, 0},
+        {"average-frames", required_argument, 0, 0},
+        {"zoom", required_argument, 0, 0},
+        {"zoom-frequency", required_argument, 0, 0},
+        {"shm", required_argument, 0, 0},
+        {"shm-slots", required_argument, 0, 0},
+        {"shm-replace", no_argument, 0, 0},
         {"magnitude-scale", required_argument, 0, 0},
         {"magnitude-min", required_argument, 0, 0},
         {"magnitude-max", required_argument, 0, 0},
+        {"magnitude-auto", no_argument, 0, 0},
         {"colors", required_argument, 0, 0},
+        {"frequency-scale", required_argument, 0, 0},
+        {"cache", required_argument, 0, 0},
+        {"pyramid", required_argument, 0, 0},
+        {"npy", required_argument, 0, 0},
+        {"npy-format", required_argument, 0, 0},
+        {"video", required_argument, 0, 0},
+        {"fps", required_argument, 0, 0},
+        {"batch", required_argument, 0, 0},
+        {"start", required_argument, 0, 0},
+        {"duration", required_argument, 0, 0},
+        {"jobs", required_argument, 0, 0},
+        {0, 0, 0, 0},
     };
 
     while (1) {
@@ -193,6 +735,52 @@ int main(int argc, char *argv[]) {
 
             if (option_name == "fullscreen") {
                 InitialSettings.fullscreen = true;
+            } else if (option_name == "raw") {
+                if (option_arg == "s16") {
+                    InitialSettings.audioRawFormat = RawAudioSource::Format::S16;
+                } else if (option_arg == "f32") {
+                    InitialSettings.audioRawFormat = RawAudioSource::Format::F32;
+                } else {
+                    std::cerr << "Invalid value for raw format.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                InitialSettings.audioRaw = true;
+            } else if (option_name == "channels") {
+                unsigned int channels;
+                try {
+                    channels = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for channels.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (channels < 1 || channels > UserLimits.audioChannelsMax) {
+                    std::cerr << "Invalid value for channels (must be >= 1 and <= " << UserLimits.audioChannelsMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.audioChannels = channels;
+            } else if (option_name == "source") {
+                AudioSourceSettings source = {option_arg, 0};
+                size_t at = option_arg.rfind('@');
+
+                if (at != std::string::npos) {
+                    source.device = option_arg.substr(0, at);
+                    try {
+                        source.sampleRate = static_cast<unsigned int>(std::stoul(option_arg.substr(at + 1)));
+                    } catch (const std::invalid_argument &e) {
+                        std::cerr << "Invalid value for source sample rate.\n\n";
+                        print_usage(argv[0]);
+                        return EXIT_FAILURE;
+                    }
+                }
+
+                InitialSettings.audioSources.push_back(source);
+            } else if (option_name == "magnitude-auto") {
+                InitialSettings.magnitudeAuto = true;
             } else if (option_name == "orientation") {
                 if (option_arg == "horizontal") {
                     InitialSettings.orientation = Orientation::Horizontal;
@@ -221,6 +809,14 @@ int main(int argc, char *argv[]) {
                     print_usage(argv[0]);
                     return EXIT_FAILURE;
                 }
+            } else if (option_name == "history") {
+                try {
+                    InitialSettings.historyDuration = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for history duration.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
             } else if (option_name == "overlap") {
                 try {
                     overlap = static_cast<unsigned int>(std::stoul(option_arg));
@@ -240,6 +836,16 @@ int main(int argc, char *argv[]) {
                 }
 
                 InitialSettings.samplesOverlap = static_cast<float>(overlap) / 100.0f;
+                dftConfigured = true;
+            } else if (option_name == "hop") {
+                try {
+                    hop = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for hop.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                dftConfigured = true;
             } else if (option_name == "dft-size") {
                 unsigned int dftSize;
                 try {
@@ -250,13 +856,48 @@ int main(int argc, char *argv[]) {
                     return EXIT_FAILURE;
                 }
 
-                if ((dftSize & (dftSize - 1)) != 0 || dftSize < UserLimits.dftSizeMin || dftSize > UserLimits.dftSizeMax) {
-                    std::cerr << "Invalid value for DFT size (must be power of 2 and >= " << UserLimits.dftSizeMin << " and <= " << UserLimits.dftSizeMax << ").\n\n";
+                if ((dftSize & (dftSize - 1)) != 0 || dftSize < UserLimits.dftSizeMin || dftSize > UserLimits.dftSizeOfflineMax) {
+                    std::cerr << "Invalid value for DFT size (must be power of 2 and >= " << UserLimits.dftSizeMin << " and <= " << UserLimits.dftSizeOfflineMax << ").\n\n";
                     print_usage(argv[0]);
                     return EXIT_FAILURE;
                 }
 
                 InitialSettings.dftSize = dftSize;
+                dftConfigured = true;
+            } else if (option_name == "dft-threads") {
+                unsigned int dftThreads;
+                try {
+                    dftThreads = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for DFT threads.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (dftThreads > UserLimits.dftThreadsMax) {
+                    std::cerr << "Invalid value for DFT threads (must be >= 0 and <= " << UserLimits.dftThreadsMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.dftThreads = dftThreads;
+            } else if (option_name == "fft-threads") {
+                unsigned int fftThreads;
+                try {
+                    fftThreads = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for FFT threads.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (fftThreads > UserLimits.dftThreadsMax) {
+                    std::cerr << "Invalid value for FFT threads (must be >= 0 and <= " << UserLimits.dftThreadsMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.fftThreads = fftThreads;
             } else if (option_name == "window") {
                 if (option_arg == "hann")
                     InitialSettings.dftWindowFunction = RealDft::WindowFunction::Hann;
@@ -271,6 +912,212 @@ int main(int argc, char *argv[]) {
                     print_usage(argv[0]);
                     return EXIT_FAILURE;
                 }
+                dftConfigured = true;
+            } else if (option_name == "engine") {
+                if (option_arg == "dft")
+                    InitialSettings.dftEngine = SpectrumEngine::Type::Dft;
+                else if (option_arg == "cqt")
+                    InitialSettings.dftEngine = SpectrumEngine::Type::ConstantQ;
+                else if (option_arg == "sdft")
+                    InitialSettings.dftEngine = SpectrumEngine::Type::SlidingDft;
+                else if (option_arg == "goertzel")
+                    InitialSettings.dftEngine = SpectrumEngine::Type::Goertzel;
+                else if (option_arg == "multitaper")
+                    InitialSettings.dftEngine = SpectrumEngine::Type::Multitaper;
+                else if (option_arg == "pfb")
+                    InitialSettings.dftEngine = SpectrumEngine::Type::Polyphase;
+                else {
+                    std::cerr << "Invalid spectrum engine.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                dftConfigured = true;
+            } else if (option_name == "cqt-bins") {
+                unsigned int cqtBinsPerOctave;
+                try {
+                    cqtBinsPerOctave = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for constant-Q bins per octave.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (cqtBinsPerOctave < UserLimits.cqtBinsPerOctaveMin || cqtBinsPerOctave > UserLimits.cqtBinsPerOctaveMax) {
+                    std::cerr << "Invalid value for constant-Q bins per octave (must be >= " << UserLimits.cqtBinsPerOctaveMin << " and <= " << UserLimits.cqtBinsPerOctaveMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.cqtBinsPerOctave = cqtBinsPerOctave;
+                dftConfigured = true;
+            } else if (option_name == "cqt-min-frequency") {
+                try {
+                    InitialSettings.cqtMinFrequency = std::stof(option_arg);
+                    dftConfigured = true;
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for constant-Q minimum frequency.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+            } else if (option_name == "average") {
+                if (option_arg == "none")
+                    InitialSettings.averageMode = SpectrumAverager::Mode::None;
+                else if (option_arg == "exponential")
+                    InitialSettings.averageMode = SpectrumAverager::Mode::Exponential;
+                else if (option_arg == "boxcar")
+                    InitialSettings.averageMode = SpectrumAverager::Mode::Boxcar;
+                else if (option_arg == "peak")
+                    InitialSettings.averageMode = SpectrumAverager::Mode::PeakHold;
+                else {
+                    std::cerr << "Invalid averaging mode.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                dftConfigured = true;
+            } else if (option_name == "average-alpha") {
+                float averageAlpha;
+                try {
+                    averageAlpha = std::stof(option_arg);
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for average alpha.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (averageAlpha <= 0.0f || averageAlpha > 1.0f) {
+                    std::cerr << "Invalid value for average alpha (must be > 0.0 and <= 1.0).\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.averageAlpha = averageAlpha;
+                dftConfigured = true;
+            } else if (option_name == "average-frames") {
+                unsigned int averageFrames;
+                try {
+                    averageFrames = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for average frames.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (averageFrames < 1 || averageFrames > UserLimits.averageFramesMax) {
+                    std::cerr << "Invalid value for average frames (must be >= 1 and <= " << UserLimits.averageFramesMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.averageFrames = averageFrames;
+                dftConfigured = true;
+            } else if (option_name == "pfb-taps") {
+                unsigned int pfbTaps;
+                try {
+                    pfbTaps = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for pfb-taps.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (pfbTaps < UserLimits.pfbTapsMin || pfbTaps > UserLimits.pfbTapsMax) {
+                    std::cerr << "Invalid value for pfb-taps (must be >= " << UserLimits.pfbTapsMin << " and <= " << UserLimits.pfbTapsMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.pfbTaps = pfbTaps;
+                dftConfigured = true;
+            } else if (option_name == "tapers") {
+                unsigned int multitaperTapers;
+                try {
+                    multitaperTapers = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for tapers.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (multitaperTapers < UserLimits.multitaperTapersMin || multitaperTapers > UserLimits.multitaperTapersMax) {
+                    std::cerr << "Invalid value for tapers (must be >= " << UserLimits.multitaperTapersMin << " and <= " << UserLimits.multitaperTapersMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.multitaperTapers = multitaperTapers;
+                dftConfigured = true;
+            } else if (option_name == "tones") {
+                std::stringstream tones(option_arg);
+                std::string tone;
+
+                InitialSettings.goertzelFrequencies.clear();
+                while (std::getline(tones, tone, ',')) {
+                    float frequency;
+                    try {
+                        frequency = std::stof(tone);
+                    } catch (const std::invalid_argument &e) {
+                        std::cerr << "Invalid value for tones.\n\n";
+                        print_usage(argv[0]);
+                        return EXIT_FAILURE;
+                    }
+
+                    if (frequency <= 0.0f) {
+                        std::cerr << "Invalid value for tones (must be > 0).\n\n";
+                        print_usage(argv[0]);
+                        return EXIT_FAILURE;
+                    }
+
+                    InitialSettings.goertzelFrequencies.push_back(frequency);
+                }
+                dftConfigured = true;
+            } else if (option_name == "zoom") {
+                unsigned int zoomDecimation;
+                try {
+                    zoomDecimation = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for zoom.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (zoomDecimation < 1 || zoomDecimation > UserLimits.zoomDecimationMax) {
+                    std::cerr << "Invalid value for zoom (must be >= 1 and <= " << UserLimits.zoomDecimationMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.zoomDecimation = zoomDecimation;
+                zoomConfigured = true;
+            } else if (option_name == "start" || option_name == "duration") {
+                float seconds;
+                try {
+                    seconds = std::stof(option_arg);
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for " << option_name << ".\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (!std::isfinite(seconds) || seconds < 0.0f) {
+                    std::cerr << "Invalid value for " << option_name << " (must be >= 0).\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (option_name == "start")
+                    InitialSettings.audioStart = seconds;
+                else
+                    InitialSettings.audioDuration = seconds;
+                rangeConfigured = true;
+            } else if (option_name == "zoom-frequency") {
+                try {
+                    InitialSettings.zoomFrequency = std::stof(option_arg);
+                    zoomConfigured = true;
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for zoom frequency.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
             } else if (option_name == "magnitude-scale") {
                 if (option_arg == "logarithmic")
                     InitialSettings.magnitudeLog = true;
@@ -309,10 +1156,116 @@ int main(int argc, char *argv[]) {
                     print_usage(argv[0]);
                     return EXIT_FAILURE;
                 }
+            } else if (option_name == "frequency-scale") {
+                if (option_arg == "linear")
+                    InitialSettings.frequencyScale = FrequencyAxis::Scale::Linear;
+                else if (option_arg == "logarithmic")
+                    InitialSettings.frequencyScale = FrequencyAxis::Scale::Logarithmic;
+                else if (option_arg == "mel")
+                    InitialSettings.frequencyScale = FrequencyAxis::Scale::Mel;
+                else {
+                    std::cerr << "Invalid frequency scale.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+            } else if (option_name == "shm") {
+                InitialSettings.frameRingName = option_arg;
+            } else if (option_name == "shm-slots") {
+                unsigned int slots;
+                try {
+                    slots = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for shared memory ring slots.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (slots < UserLimits.frameRingSlotsMin || slots > UserLimits.frameRingSlotsMax) {
+                    std::cerr << "Invalid value for shared memory ring slots (must be >= " << UserLimits.frameRingSlotsMin << " and <= " << UserLimits.frameRingSlotsMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.frameRingSlots = slots;
+            } else if (option_name == "shm-replace") {
+                InitialSettings.frameRingReplace = true;
+            } else if (option_name == "cache") {
+                cachePath = option_arg;
+            } else if (option_name == "pyramid") {
+                pyramidPath = option_arg;
+            } else if (option_name == "npy") {
+                npyPath = option_arg;
+            } else if (option_name == "npy-format") {
+                if (option_arg == "power")
+                    InitialSettings.npyFormat = NpyMagnitudeWriter::Format::Power;
+                else if (option_arg == "magnitude")
+                    InitialSettings.npyFormat = NpyMagnitudeWriter::Format::Magnitude;
+                else if (option_arg == "u16")
+                    InitialSettings.npyFormat = NpyMagnitudeWriter::Format::U16;
+                else if (option_arg == "u8")
+                    InitialSettings.npyFormat = NpyMagnitudeWriter::Format::U8;
+                else {
+                    std::cerr << "Invalid NPY format.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+            } else if (option_name == "video") {
+                videoPath = option_arg;
+            } else if (option_name == "fps") {
+                unsigned int fps;
+                try {
+                    fps = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for fps.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (fps < 1 || fps > UserLimits.videoFpsMax) {
+                    std::cerr << "Invalid value for fps (must be >= 1 and <= " << UserLimits.videoFpsMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                InitialSettings.videoFps = fps;
+            } else if (option_name == "batch") {
+                batchPath = option_arg;
+            } else if (option_name == "jobs") {
+                try {
+                    jobs = static_cast<unsigned int>(std::stoul(option_arg));
+                } catch (const std::invalid_argument &e) {
+                    std::cerr << "Invalid value for jobs.\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                if (jobs > UserLimits.batchJobsMax) {
+                    std::cerr << "Invalid value for jobs (must be >= 0 and <= " << UserLimits.batchJobsMax << ").\n\n";
+                    print_usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
             }
         }
     }
 
+    /* Validate Goertzel engine has tones */
+    if (InitialSettings.dftEngine == SpectrumEngine::Type::Goertzel && InitialSettings.goertzelFrequencies.empty()) {
+        std::cerr << "Goertzel engine requires tones.\n\n";
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Validate hop with DFT size, and convert to samples overlap */
+    if (hop > 0) {
+        if (hop >= InitialSettings.dftSize) {
+            std::cerr << "Invalid value for hop (must be >= 1 and < " << InitialSettings.dftSize << ").\n\n";
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        InitialSettings.samplesOverlap = static_cast<float>(InitialSettings.dftSize - hop) / static_cast<float>(InitialSettings.dftSize);
+    }
+
     /* Validate magnitude min/max with magnitude scale mode */
     if (InitialSettings.magnitudeLog) {
         if (InitialSettings.magnitudeMin < UserLimits.magnitudeLogMin) {
@@ -336,24 +1289,160 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    if ((argc - optind) > 0 && (argc - optind) != 2) {
+    /* Standard output carries a single stream */
+    if (npyPath == "-" && videoPath == "-") {
+        std::cerr << "NPY and video outputs cannot both be written to standard output.\n\n";
         print_usage(argv[0]);
         return EXIT_FAILURE;
     }
 
-    /* Audio file mode */
-    if ((argc - optind) == 2) {
+    /* NPY header on standard output cannot be rewritten, so the row count must be known up front */
+    if (npyPath == "-" && InitialSettings.audioRaw) {
+        std::cerr << "NPY output to standard output requires a WAV file input, as the row count of raw input is not known up front.\n\n";
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Batch mode */
+    if (batchPath != "") {
+        if ((argc - optind) < 1) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        if (zoomConfigured)
+            std::cerr << "Warning: zoom options ignored. zoom is only available in real-time mode." << std::endl;
         if (sampleRateConfigured)
             std::cerr << "Warning: sample rate option ignored. sample rate is determined by audio file." << std::endl;
-        if (InitialSettings.orientation == Orientation::Vertical && heightConfigured)
+        if (cachePath != "" || pyramidPath != "" || npyPath != "" || videoPath != "")
+            std::cerr << "Warning: cache, pyramid, NPY, and video options ignored. batch mode writes images only." << std::endl;
+        if (InitialSettings.frameRingName != "")
+            std::cerr << "Warning: shm option ignored. frames are only published to shared memory in real-time mode." << std::endl;
+
+        /* Parallelize across files, rather than within large DFTs, unless configured */
+        if (InitialSettings.fftThreads == 0)
+            InitialSettings.fftThreads = 1;
+
+        return spectrogram_batch(std::vector<std::string>(argv + optind, argv + argc), batchPath, jobs) ? 0 : EXIT_FAILURE;
+    }
+
+    if ((argc - optind) > 2) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Large DFT sizes are only available in WAV file, pyramid, NPY, and video modes */
+    if (InitialSettings.dftSize > UserLimits.dftSizeMax && !((argc - optind) == 2 || ((argc - optind) == 1 && (pyramidPath != "" || npyPath != "" || videoPath != "")))) {
+        std::cerr << "Invalid value for DFT size (must be <= " << UserLimits.dftSizeMax << " in real-time and WAV viewer modes).\n\n";
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Audio file mode, or pyramid, NPY, or video mode with no image output */
+    if ((argc - optind) == 2 || ((argc - optind) == 1 && (pyramidPath != "" || npyPath != "" || videoPath != ""))) {
+        std::string imagePath = ((argc - optind) == 2) ? std::string(argv[optind + 1]) : "";
+
+        if (zoomConfigured)
+            std::cerr << "Warning: zoom options ignored. zoom is only available in real-time mode." << std::endl;
+        if (sampleRateConfigured && !InitialSettings.audioRaw)
+            std::cerr << "Warning: sample rate option ignored. sample rate is determined by audio file." << std::endl;
+        if (!InitialSettings.audioSources.empty())
+            std::cerr << "Warning: source option ignored. sources are only used in real-time mode." << std::endl;
+        if (InitialSettings.audioRaw && InitialSettings.magnitudeAuto) {
+            std::cerr << "Warning: magnitude auto option ignored. raw input is read in a single pass." << std::endl;
+            InitialSettings.magnitudeAuto = false;
+        }
+        if (InitialSettings.orientation == Orientation::Vertical && heightConfigured && videoPath == "")
             std::cerr << "Warning: height option ignored. height in vertical orientation is determined by audio length and samples overlap percentage." << std::endl;
-        if (InitialSettings.orientation == Orientation::Horizontal && widthConfigured)
+        if (InitialSettings.orientation == Orientation::Horizontal && widthConfigured && videoPath == "")
             std::cerr << "Warning: width option ignored. width in horizontal orientation is determined by audio length and samples overlap percentage." << std::endl;
+        if (InitialSettings.frameRingName != "")
+            std::cerr << "Warning: shm option ignored. frames are only published to shared memory in real-time mode." << std::endl;
+
+        if (!InitialSettings.audioRaw && MagnitudeCacheReader::isMagnitudeCache(argv[optind])) {
+            if (dftConfigured)
+                std::cerr << "Warning: DFT options ignored. DFT settings are determined by magnitude cache." << std::endl;
+            if (cachePath != "")
+                std::cerr << "Warning: cache option ignored. input is already a magnitude cache." << std::endl;
+            if (rangeConfigured)
+                std::cerr << "Warning: start and duration options ignored. time range is only available in WAV file mode." << std::endl;
+            if (npyPath != "")
+                std::cerr << "Warning: NPY option ignored. magnitude cache holds quantized magnitudes, not spectra." << std::endl;
 
-        spectrogram_audiofile(std::string(argv[optind]), std::string(argv[optind + 1]));
+            spectrogram_cachefile(std::string(argv[optind]), imagePath, pyramidPath, videoPath);
+        } else {
+            if (cachePath != "" && (InitialSettings.dftEngine == SpectrumEngine::Type::ConstantQ || InitialSettings.dftEngine == SpectrumEngine::Type::Goertzel)) {
+                std::cerr << "Warning: cache option ignored. magnitude cache holds DFT bins, not constant-Q bins or Goertzel tones." << std::endl;
+                cachePath = "";
+            }
+
+            try {
+                spectrogram_audiofile(std::string(argv[optind]), imagePath, cachePath, pyramidPath, npyPath, videoPath);
+            } catch (const RangeException &e) {
+                std::cerr << e.what() << "\n\n";
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        /* Raw PCM real-time mode */
+    } else if ((argc - optind) == 1 && InitialSettings.audioRaw) {
+        if (!InitialSettings.audioSources.empty())
+            std::cerr << "Warning: source option ignored. input is a raw PCM stream." << std::endl;
+        if (rangeConfigured)
+            std::cerr << "Warning: start and duration options ignored. time range is only available in WAV file mode." << std::endl;
+
+        InitialSettings.audioPath = std::string(argv[optind]);
+        spectrogram_realtime();
+
+        /* Audio file viewer mode */
+    } else if ((argc - optind) == 1) {
+        if (sampleRateConfigured)
+            std::cerr << "Warning: sample rate option ignored. sample rate is determined by audio file." << std::endl;
+        if (!InitialSettings.audioSources.empty())
+            std::cerr << "Warning: source option ignored. sources are only used in real-time mode." << std::endl;
+        if (cachePath != "")
+            std::cerr << "Warning: cache option ignored. cache is only written in WAV file mode." << std::endl;
+        if (zoomConfigured)
+            std::cerr << "Warning: zoom options ignored. zoom is only available in real-time mode." << std::endl;
+        if (InitialSettings.frequencyScale != FrequencyAxis::Scale::Linear)
+            std::cerr << "Warning: frequency scale option ignored. WAV viewer uses a linear frequency axis." << std::endl;
+        if (InitialSettings.dftEngine != SpectrumEngine::Type::Dft)
+            std::cerr << "Warning: engine option ignored. WAV viewer uses the DFT engine." << std::endl;
+        if (InitialSettings.magnitudeAuto)
+            std::cerr << "Warning: magnitude auto option ignored. WAV viewer uses a fixed magnitude range." << std::endl;
+        if (InitialSettings.averageMode != SpectrumAverager::Mode::None)
+            std::cerr << "Warning: average option ignored. WAV viewer does not average spectra." << std::endl;
+        if (rangeConfigured)
+            std::cerr << "Warning: start and duration options ignored. time range is only available in WAV file mode." << std::endl;
+        if (InitialSettings.frameRingName != "")
+            std::cerr << "Warning: shm option ignored. frames are only published to shared memory in real-time mode." << std::endl;
+
+        spectrogram_viewer(std::string(argv[optind]));
 
         /* Realtime mode */
+    } else if (InitialSettings.audioRaw) {
+        std::cerr << "Raw PCM input requires an input path, or - for standard input.\n\n";
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    } else if (InitialSettings.audioSources.size() > 1) {
+        if (rangeConfigured)
+            std::cerr << "Warning: start and duration options ignored. time range is only available in WAV file mode." << std::endl;
+        if (npyPath != "" || videoPath != "")
+            std::cerr << "Warning: NPY and video options ignored. NPY and video output are only written in WAV file mode." << std::endl;
+        if (InitialSettings.frameRingName != "")
+            std::cerr << "Warning: shm option ignored. frames are not published to shared memory for a mosaic of sources." << std::endl;
+
+        spectrogram_mosaic();
     } else {
+        if (rangeConfigured)
+            std::cerr << "Warning: start and duration options ignored. time range is only available in WAV file mode." << std::endl;
+        if (npyPath != "" || videoPath != "")
+            std::cerr << "Warning: NPY and video options ignored. NPY and video output are only written in WAV file mode." << std::endl;
+
+        if (InitialSettings.audioSources.size() == 1 && InitialSettings.audioSources[0].sampleRate != 0)
+            InitialSettings.audioSampleRate = InitialSettings.audioSources[0].sampleRate;
+
         spectrogram_realtime();
     }
 
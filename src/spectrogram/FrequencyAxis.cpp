@@ -0,0 +1,142 @@
+#include <cmath>
+#include <algorithm>
+
+#include "SpectrumRenderer.hpp"
+#include "FrequencyAxis.hpp"
+
+namespace Spectrogram {
+
+constexpr float FrequencyAxis::LogarithmicMin;
+
+static float frequencyToMel(float frequency) {
+    return 2595.0f * std::log10(1.0f + frequency / 700.0f);
+}
+
+static float melToFrequency(float mel) {
+    return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+FrequencyAxis::FrequencyAxis(Scale scale) : _scale(scale) {
+}
+
+float FrequencyAxis::getFrequency(Scale scale, float position, unsigned int sampleRate) {
+    float nyquist = static_cast<float>(sampleRate) / 2.0f;
+
+    if (scale == Scale::Logarithmic)
+        return LogarithmicMin * std::pow(nyquist / LogarithmicMin, position);
+    else if (scale == Scale::Mel)
+        return melToFrequency(position * frequencyToMel(nyquist));
+
+    return position * nyquist;
+}
+
+void FrequencyAxis::_update(size_t width, size_t bins, unsigned int sampleRate) {
+    /* Rebuild only on a change of geometry */
+    if (width == _width && bins == _bins && sampleRate == _sampleRate)
+        return;
+
+    _width = width;
+    _bins = bins;
+    _sampleRate = sampleRate;
+
+    _offsets.clear();
+    _indices.clear();
+    _weights.clear();
+    _power.resize(bins);
+
+    float hzPerBin = (static_cast<float>(sampleRate) / 2.0f) / static_cast<float>(bins - 1);
+
+    for (size_t i = 0; i < width; i++) {
+        float low = getFrequency(_scale, static_cast<float>(i) / static_cast<float>(width), sampleRate) / hzPerBin;
+        float high = getFrequency(_scale, static_cast<float>(i + 1) / static_cast<float>(width), sampleRate) / hzPerBin;
+
+        size_t first = std::min(static_cast<size_t>(std::ceil(low)), bins);
+        size_t last = std::min(static_cast<size_t>(std::ceil(high)), bins);
+
+        _offsets.push_back(static_cast<uint32_t>(_indices.size()));
+
+        if (last > first) {
+            /* Average power of bins within the pixel */
+            for (size_t k = first; k < last; k++) {
+                _indices.push_back(static_cast<uint32_t>(k));
+                _weights.push_back(1.0f / static_cast<float>(last - first));
+            }
+        } else {
+            /* Pixel narrower than a bin, interpolate between neighboring bins at its center */
+            float center = std::min((low + high) / 2.0f, static_cast<float>(bins - 1));
+            size_t k = std::min(static_cast<size_t>(center), bins - 2);
+            float fraction = center - static_cast<float>(k);
+
+            _indices.push_back(static_cast<uint32_t>(k));
+            _weights.push_back(1.0f - fraction);
+            _indices.push_back(static_cast<uint32_t>(k + 1));
+            _weights.push_back(fraction);
+        }
+    }
+
+    _offsets.push_back(static_cast<uint32_t>(_indices.size()));
+}
+
+void FrequencyAxis::quantize(std::vector<uint16_t> &magnitudes, const std::vector<std::complex<float>> &dft, unsigned int sampleRate) {
+    if (_scale == Scale::Linear) {
+        SpectrumRenderer::quantize(magnitudes, dft);
+        return;
+    }
+
+    _update(magnitudes.size(), dft.size(), sampleRate);
+
+    /* Bin powers */
+    for (size_t k = 0; k < dft.size(); k++)
+        _power[k] = std::norm(dft[k]);
+
+    /* Gather and reduce bin powers for each pixel */
+    for (size_t i = 0; i < magnitudes.size(); i++) {
+        float power = 0.0f;
+        for (uint32_t j = _offsets[i]; j < _offsets[i + 1]; j++)
+            power += _weights[j] * _power[_indices[j]];
+
+        magnitudes[i] = SpectrumRenderer::quantize(10.0f * std::log10(power));
+    }
+}
+
+void FrequencyAxis::resample(std::vector<uint16_t> &magnitudes, const uint16_t *bins, size_t count, unsigned int sampleRate) {
+    if (_scale == Scale::Linear) {
+        SpectrumRenderer::resample(magnitudes, bins, count);
+        return;
+    }
+
+    _update(magnitudes.size(), count, sampleRate);
+
+    /* Gather and reduce quantized magnitudes for each pixel */
+    for (size_t i = 0; i < magnitudes.size(); i++) {
+        float magnitude = 0.0f;
+        for (uint32_t j = _offsets[i]; j < _offsets[i + 1]; j++)
+            magnitude += _weights[j] * static_cast<float>(bins[_indices[j]]);
+
+        magnitudes[i] = static_cast<uint16_t>(magnitude + 0.5f);
+    }
+}
+
+FrequencyAxis::Scale FrequencyAxis::getScale() {
+    return _scale;
+}
+
+void FrequencyAxis::setScale(Scale scale) {
+    _scale = scale;
+
+    /* Force weight table rebuild */
+    _width = 0;
+}
+
+std::string to_string(const FrequencyAxis::Scale &scale) {
+    if (scale == FrequencyAxis::Scale::Linear)
+        return "Linear";
+    else if (scale == FrequencyAxis::Scale::Logarithmic)
+        return "Logarithmic";
+    else if (scale == FrequencyAxis::Scale::Mel)
+        return "Mel";
+
+    return "Unknown";
+}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <cstdint>
+#include <cstddef>
+
+namespace Spectrogram {
+
+class FrequencyAxis {
+  public:
+    enum class Scale { Linear,
+                       Logarithmic,
+                       Mel };
+
+    /* Lowest frequency of the logarithmic scale in Hz */
+    static constexpr float LogarithmicMin = 20.0f;
+
+    FrequencyAxis(Scale scale);
+
+    /* Quantize a real DFT vector into a row of logarithmic magnitudes on this axis */
+    void quantize(std::vector<uint16_t> &magnitudes, const std::vector<std::complex<float>> &dft, unsigned int sampleRate);
+
+    /* Resample quantized magnitudes of real DFT bins to a row on this axis */
+    void resample(std::vector<uint16_t> &magnitudes, const uint16_t *bins, size_t count, unsigned int sampleRate);
+
+    /* Get/Set Scale */
+    Scale getScale();
+    void setScale(Scale scale);
+
+    /* Map a position along the axis (0.0 to 1.0) to frequency in Hz */
+    static float getFrequency(Scale scale, float position, unsigned int sampleRate);
+
+  private:
+    void _update(size_t width, size_t bins, unsigned int sampleRate);
+
+    Scale _scale;
+
+    /* Geometry the weight table was built for */
+    size_t _width = 0;
+    size_t _bins = 0;
+    unsigned int _sampleRate = 0;
+
+    /* Sparse pixel to bin weight table, pixel i spans entries _offsets[i] to _offsets[i + 1] */
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _indices;
+    std::vector<float> _weights;
+
+    /* Scratch bin powers */
+    std::vector<float> _power;
+};
+
+std::string to_string(const FrequencyAxis::Scale &scale);
+
+}
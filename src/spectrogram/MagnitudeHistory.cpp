@@ -0,0 +1,73 @@
+#include <algorithm>
+
+#include "MagnitudeHistory.hpp"
+
+namespace Spectrogram {
+
+MagnitudeHistory::MagnitudeHistory(size_t rows, size_t width) {
+    resize(rows, width);
+}
+
+void MagnitudeHistory::push(const std::vector<uint16_t> &magnitudes, double time) {
+    uint16_t *dest;
+    size_t index;
+
+    if (_rows == 0)
+        return;
+
+    if (_count < _rows) {
+        /* Grow buffer by one row, without overshooting capacity */
+        if (_buffer.capacity() < (_count + 1) * _width)
+            _buffer.reserve(std::min(std::max(_buffer.capacity() * 2, (_count + 1) * _width), _rows * _width));
+
+        _buffer.resize((_count + 1) * _width);
+        _times.resize(_count + 1);
+        index = _count;
+        _count++;
+    } else {
+        /* Overwrite oldest row */
+        index = _head;
+        _head = (_head + 1) % _rows;
+    }
+
+    dest = _buffer.data() + index * _width;
+    _times[index] = time;
+
+    /* Copy row, truncating or zero padding to our width */
+    size_t count = std::min(magnitudes.size(), _width);
+    std::copy(magnitudes.begin(), magnitudes.begin() + static_cast<std::ptrdiff_t>(count), dest);
+    std::fill(dest + count, dest + _width, 0);
+}
+
+const uint16_t *MagnitudeHistory::row(size_t index) {
+    return _buffer.data() + ((_head + index) % _rows) * _width;
+}
+
+double MagnitudeHistory::time(size_t index) {
+    return _times[(_head + index) % _rows];
+}
+
+size_t MagnitudeHistory::getCount() {
+    return _count;
+}
+
+size_t MagnitudeHistory::getRows() {
+    return _rows;
+}
+
+size_t MagnitudeHistory::getWidth() {
+    return _width;
+}
+
+void MagnitudeHistory::resize(size_t rows, size_t width) {
+    _rows = rows;
+    _width = width;
+    _count = 0;
+    _head = 0;
+
+    /* Release old rows */
+    std::vector<uint16_t>().swap(_buffer);
+    std::vector<double>().swap(_times);
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Spectrogram {
+
+class MagnitudeHistory {
+  public:
+    MagnitudeHistory(size_t rows, size_t width);
+
+    /* Push a new row of quantized magnitudes with its time in seconds, replacing the oldest row when full */
+    void push(const std::vector<uint16_t> &magnitudes, double time);
+
+    /* Get row of quantized magnitudes (0 is the oldest) */
+    const uint16_t *row(size_t index);
+
+    /* Get time of row in seconds (0 is the oldest) */
+    double time(size_t index);
+
+    /* Get number of rows stored */
+    size_t getCount();
+
+    /* Get/Set Capacity in Rows and Row Width (clears history) */
+    size_t getRows();
+    size_t getWidth();
+    void resize(size_t rows, size_t width);
+
+  private:
+    /* Rows of quantized magnitudes, grown on demand up to capacity */
+    std::vector<uint16_t> _buffer;
+    /* Times of rows, parallel to rows */
+    std::vector<double> _times;
+    /* Capacity in rows, row width */
+    size_t _rows, _width;
+    /* Number of rows stored */
+    size_t _count;
+    /* Index of oldest row */
+    size_t _head;
+};
+
+}
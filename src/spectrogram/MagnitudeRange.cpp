@@ -0,0 +1,74 @@
+#include <limits>
+
+#include "SpectrumRenderer.hpp"
+#include "MagnitudeRange.hpp"
+
+namespace Spectrogram {
+
+constexpr size_t MagnitudeRange::Buckets;
+constexpr float MagnitudeRange::NoisePercentile;
+constexpr float MagnitudeRange::PeakPercentile;
+constexpr float MagnitudeRange::SpanMin;
+
+/* Quantized magnitudes per bucket */
+static constexpr size_t BucketWidth = (static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 1) / MagnitudeRange::Buckets;
+
+MagnitudeRange::MagnitudeRange() : _histogram(Buckets, 0.0) {
+}
+
+void MagnitudeRange::append(const uint16_t *magnitudes, size_t count) {
+    double *histogram = _histogram.data();
+    size_t counted = 0;
+
+    /* Skip the floor, which holds blanked bins and bins of zero power rather than magnitudes */
+    for (size_t i = 0; i < count; i++) {
+        if (magnitudes[i] == 0)
+            continue;
+
+        histogram[magnitudes[i] / BucketWidth] += 1.0;
+        counted++;
+    }
+
+    _count += static_cast<double>(counted);
+}
+
+void MagnitudeRange::decay(float factor) {
+    for (size_t i = 0; i < Buckets; i++)
+        _histogram[i] *= static_cast<double>(factor);
+
+    _count *= static_cast<double>(factor);
+}
+
+void MagnitudeRange::reset() {
+    _histogram.assign(Buckets, 0.0);
+    _count = 0.0;
+}
+
+double MagnitudeRange::getCount() {
+    return _count;
+}
+
+float MagnitudeRange::getPercentile(float percentile) {
+    double target = static_cast<double>(percentile) * _count;
+    double sum = 0.0;
+    size_t i = 0;
+
+    for (; i < Buckets - 1; i++) {
+        sum += _histogram[i];
+        if (sum >= target)
+            break;
+    }
+
+    /* Center of the bucket */
+    return SpectrumRenderer::dequantize(static_cast<uint16_t>(i * BucketWidth + BucketWidth / 2));
+}
+
+void MagnitudeRange::getRange(float &min, float &max) {
+    min = getPercentile(NoisePercentile);
+    max = getPercentile(PeakPercentile);
+
+    if (max - min < SpanMin)
+        max = min + SpanMin;
+}
+
+}
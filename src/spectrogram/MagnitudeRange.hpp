@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Spectrogram {
+
+/*
+ * Streaming estimate of the noise floor and peak level of quantized magnitudes.
+ *
+ * A histogram of Buckets buckets over the quantized magnitude range counts every
+ * magnitude appended, at the cost of one increment per magnitude. The floor code
+ * 0 is not counted, as it marks blanked bins (zoom band edges) and bins of zero
+ * or non-finite power, which would otherwise drag the noise floor down to it. Percentiles
+ * are read from the cumulative histogram. Recent rows are favored by decaying
+ * the histogram periodically, which keeps the estimate independent of the row
+ * rate, while a histogram that is never decayed covers a whole file.
+ */
+class MagnitudeRange {
+  public:
+    /* Histogram buckets over the quantized magnitude range */
+    static constexpr size_t Buckets = 1024;
+
+    /* Percentiles of the noise floor and peak level */
+    static constexpr float NoisePercentile = 0.25f;
+    static constexpr float PeakPercentile = 0.999f;
+
+    /* Minimum span of the range in dB */
+    static constexpr float SpanMin = 10.0f;
+
+    MagnitudeRange();
+
+    /* Count a row of quantized magnitudes, skipping the floor code 0 */
+    void append(const uint16_t *magnitudes, size_t count);
+
+    /* Scale down all counts by factor (0.0 to 1.0) */
+    void decay(float factor);
+
+    /* Clear all counts */
+    void reset();
+
+    /* Get number of magnitudes counted, after decay */
+    double getCount();
+
+    /* Get magnitude at percentile (0.0 to 1.0) in dB */
+    float getPercentile(float percentile);
+
+    /* Get noise floor and peak level in dB, at least SpanMin apart */
+    void getRange(float &min, float &max);
+
+  private:
+    std::vector<double> _histogram;
+    double _count = 0.0;
+};
+
+}
@@ -0,0 +1,121 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "SpectrumAverager.hpp"
+
+namespace Spectrogram {
+
+std::string to_string(const SpectrumAverager::Mode &mode) {
+    if (mode == SpectrumAverager::Mode::None)
+        return "None";
+    else if (mode == SpectrumAverager::Mode::Exponential)
+        return "Exponential";
+    else if (mode == SpectrumAverager::Mode::Boxcar)
+        return "Boxcar";
+    else if (mode == SpectrumAverager::Mode::PeakHold)
+        return "Peak Hold";
+
+    return "";
+}
+
+SpectrumAverager::SpectrumAverager(Mode mode, float alpha, unsigned int frames) : _mode(mode), _alpha(alpha), _frames(frames) {
+}
+
+void SpectrumAverager::process(std::vector<std::complex<float>> &dft) {
+    if (_mode == Mode::None)
+        return;
+
+    size_t bins = dft.size();
+
+    /* Restart on a change of bins */
+    if (_accumulator.size() != bins) {
+        _power.resize(bins);
+        _accumulator.resize(bins);
+        _count = 0;
+    }
+
+    float *power = _power.data();
+    float *accumulator = _accumulator.data();
+
+    for (size_t k = 0; k < bins; k++)
+        power[k] = std::norm(dft[k]);
+
+    if (_count == 0) {
+        memcpy(accumulator, power, sizeof(float) * bins);
+    } else if (_mode == Mode::Exponential) {
+        float alpha = _alpha;
+        for (size_t k = 0; k < bins; k++)
+            accumulator[k] += alpha * (power[k] - accumulator[k]);
+    } else if (_mode == Mode::PeakHold) {
+        float release = 1.0f - _alpha;
+        for (size_t k = 0; k < bins; k++)
+            accumulator[k] = std::max(power[k], accumulator[k] * release);
+    }
+
+    if (_mode == Mode::Boxcar) {
+        if (_count == 0) {
+            _ring.assign(static_cast<size_t>(_frames) * bins, 0.0f);
+            _ringIndex = 0;
+        }
+
+        float *oldest = _ring.data() + _ringIndex * bins;
+
+        if (_count == 0) {
+            /* Accumulator already holds this frame */
+        } else if (_ringIndex == 0) {
+            /* Recompute the running sum once per pass over the ring, bounding rounding drift */
+            memcpy(accumulator, power, sizeof(float) * bins);
+            for (size_t i = 1; i < _frames; i++) {
+                const float *frame = _ring.data() + i * bins;
+                for (size_t k = 0; k < bins; k++)
+                    accumulator[k] += frame[k];
+            }
+        } else {
+            for (size_t k = 0; k < bins; k++)
+                accumulator[k] += power[k] - oldest[k];
+        }
+
+        memcpy(oldest, power, sizeof(float) * bins);
+        _ringIndex = (_ringIndex + 1) % _frames;
+    }
+
+    _count++;
+
+    /* Write back magnitudes, averaging the boxcar sum over the frames seen so far */
+    float scale = (_mode == Mode::Boxcar) ? 1.0f / static_cast<float>(std::min<size_t>(_count, _frames)) : 1.0f;
+    for (size_t k = 0; k < bins; k++)
+        dft[k] = std::sqrt(accumulator[k] * scale);
+}
+
+void SpectrumAverager::reset() {
+    _count = 0;
+}
+
+SpectrumAverager::Mode SpectrumAverager::getMode() {
+    return _mode;
+}
+
+void SpectrumAverager::setMode(Mode mode) {
+    _mode = mode;
+    _count = 0;
+}
+
+float SpectrumAverager::getAlpha() {
+    return _alpha;
+}
+
+void SpectrumAverager::setAlpha(float alpha) {
+    _alpha = alpha;
+}
+
+unsigned int SpectrumAverager::getFrames() {
+    return _frames;
+}
+
+void SpectrumAverager::setFrames(unsigned int frames) {
+    _frames = frames;
+    _count = 0;
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+namespace Spectrogram {
+
+/*
+ * Averaging of spectra across frames, in the power domain.
+ *
+ * Each frame's bin powers update a per-bin accumulator in place: an
+ * exponential moving average with weight alpha, a boxcar average over the
+ * last N frames kept as a running sum over a ring of frames, or a peak hold
+ * released by alpha per frame. The result is written back to the spectrum as
+ * magnitudes, ahead of the logarithm and quantization. Buffers are resized
+ * only when the number of bins or the frames change, and the accumulator
+ * restarts then.
+ */
+class SpectrumAverager {
+  public:
+    enum class Mode { None,
+                      Exponential,
+                      Boxcar,
+                      PeakHold };
+
+    SpectrumAverager(Mode mode, float alpha, unsigned int frames);
+
+    /* Average spectrum in place with the previous frames */
+    void process(std::vector<std::complex<float>> &dft);
+
+    /* Restart averaging from the next frame */
+    void reset();
+
+    /* Get/Set Mode */
+    Mode getMode();
+    void setMode(Mode mode);
+
+    /* Get/Set Exponential weight and peak hold release, 0.0 to 1.0 */
+    float getAlpha();
+    void setAlpha(float alpha);
+
+    /* Get/Set Boxcar frames */
+    unsigned int getFrames();
+    void setFrames(unsigned int frames);
+
+  private:
+    Mode _mode;
+    float _alpha;
+    unsigned int _frames;
+
+    /* Scratch bin powers */
+    std::vector<float> _power;
+    /* Per bin average, running sum, or peak */
+    std::vector<float> _accumulator;
+    /* Ring of the last frames' bin powers (boxcar) */
+    std::vector<float> _ring;
+    size_t _ringIndex = 0;
+    /* Frames accumulated since the last reset */
+    size_t _count = 0;
+};
+
+std::string to_string(const SpectrumAverager::Mode &mode);
+
+}
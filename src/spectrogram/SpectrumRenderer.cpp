@@ -1,8 +1,16 @@
+#include <cmath>
+#include <limits>
+
 #include "SpectrumRenderer.hpp"
 
 namespace Spectrogram {
 
-SpectrumRenderer::SpectrumRenderer(float magnitudeMin, float magnitudeMax, bool magnitudeLog, ColorScheme colorScheme) : _magnitudeMin(magnitudeMin), _magnitudeMax(magnitudeMax), _magnitudeLog(magnitudeLog), _colorScheme(colorScheme) {}
+constexpr float SpectrumRenderer::QuantizedMagnitudeMin;
+constexpr float SpectrumRenderer::QuantizedMagnitudeMax;
+
+SpectrumRenderer::SpectrumRenderer(float magnitudeMin, float magnitudeMax, bool magnitudeLog, ColorScheme colorScheme) : _magnitudeMin(magnitudeMin), _magnitudeMax(magnitudeMax), _magnitudeLog(magnitudeLog), _colorScheme(colorScheme) {
+    _updateColorMap();
+}
 
 template <typename T>
 static constexpr T normalize(T value, T min, T max) {
@@ -69,10 +77,8 @@ static uint32_t valueToPixel_Grayscale(float value) {
     return (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(c) << 8) | (static_cast<uint32_t>(c));
 }
 
-void SpectrumRenderer::render(std::vector<uint32_t> &pixels, const std::vector<std::complex<float>> &dft) {
-    unsigned int i;
+void SpectrumRenderer::_updateColorMap() {
     uint32_t (*valueToPixel)(float) = nullptr;
-    float (*processMagnitude)(float) = nullptr;
 
     if (_colorScheme == SpectrumRenderer::ColorScheme::Heat)
         valueToPixel = valueToPixel_Heat;
@@ -81,25 +87,70 @@ void SpectrumRenderer::render(std::vector<uint32_t> &pixels, const std::vector<s
     else if (_colorScheme == SpectrumRenderer::ColorScheme::Grayscale)
         valueToPixel = valueToPixel_Grayscale;
 
-    if (_magnitudeLog)
-        processMagnitude = [](float x) -> float { return 20 * std::log10(x); };
-    else
-        processMagnitude = [](float x) -> float { return x; };
+    /* Map every quantized magnitude to a pixel */
+    _colorMap.resize(static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 1);
+    float step = (QuantizedMagnitudeMax - QuantizedMagnitudeMin) / static_cast<float>(std::numeric_limits<uint16_t>::max());
+    for (size_t i = 0; i < _colorMap.size(); i++) {
+        float magnitude = QuantizedMagnitudeMin + step * static_cast<float>(i);
+        if (!_magnitudeLog)
+            magnitude = std::pow(10.0f, magnitude / 20.0f);
+        _colorMap[i] = valueToPixel(normalize(magnitude, _magnitudeMin, _magnitudeMax));
+    }
+}
+
+uint16_t SpectrumRenderer::quantize(float magnitude) {
+    const float scale = static_cast<float>(std::numeric_limits<uint16_t>::max()) / (QuantizedMagnitudeMax - QuantizedMagnitudeMin);
+
+    /* Map non-finite magnitudes (NaN from a diverged engine or averager) to the floor, as clamping passes NaN through */
+    if (!std::isfinite(magnitude))
+        return 0;
+
+    return static_cast<uint16_t>(scale * (std::max(std::min(magnitude, QuantizedMagnitudeMax), QuantizedMagnitudeMin) - QuantizedMagnitudeMin) + 0.5f);
+}
+
+float SpectrumRenderer::dequantize(uint16_t magnitude) {
+    const float step = (QuantizedMagnitudeMax - QuantizedMagnitudeMin) / static_cast<float>(std::numeric_limits<uint16_t>::max());
+
+    return QuantizedMagnitudeMin + step * static_cast<float>(magnitude);
+}
 
-    /* Generate pixel row for this DFT */
-    float index_scale = static_cast<float>(dft.size()) / static_cast<float>(pixels.size());
-    for (i = 0; i < pixels.size(); i++) {
-        float magnitude = processMagnitude(std::abs(dft[static_cast<unsigned int>(index_scale * static_cast<float>(i))]));
-        pixels[i] = valueToPixel(normalize(magnitude, _magnitudeMin, _magnitudeMax));
+void SpectrumRenderer::quantize(std::vector<uint16_t> &magnitudes, const std::vector<std::complex<float>> &dft) {
+    /* Generate quantized magnitude row for this DFT */
+    float index_scale = static_cast<float>(dft.size()) / static_cast<float>(magnitudes.size());
+    for (unsigned int i = 0; i < magnitudes.size(); i++) {
+        const std::complex<float> &x = dft[static_cast<unsigned int>(index_scale * static_cast<float>(i))];
+        magnitudes[i] = quantize(10.0f * std::log10(std::norm(x)));
     }
 }
 
+void SpectrumRenderer::resample(std::vector<uint16_t> &magnitudes, const uint16_t *bins, size_t count) {
+    /* Pick bins with the same mapping as quantize() */
+    float index_scale = static_cast<float>(count) / static_cast<float>(magnitudes.size());
+    for (unsigned int i = 0; i < magnitudes.size(); i++)
+        magnitudes[i] = bins[static_cast<unsigned int>(index_scale * static_cast<float>(i))];
+}
+
+void SpectrumRenderer::render(uint32_t *pixels, const uint16_t *magnitudes, size_t count) {
+    const uint32_t *colorMap = _colorMap.data();
+
+    for (size_t i = 0; i < count; i++)
+        pixels[i] = colorMap[magnitudes[i]];
+}
+
+void SpectrumRenderer::render(std::vector<uint32_t> &pixels, const std::vector<std::complex<float>> &dft) {
+    _magnitudes.resize(pixels.size());
+
+    quantize(_magnitudes, dft);
+    render(pixels.data(), _magnitudes.data(), pixels.size());
+}
+
 float SpectrumRenderer::getMagnitudeMin() {
     return _magnitudeMin;
 }
 
 void SpectrumRenderer::setMagnitudeMin(float min) {
     _magnitudeMin = min;
+    _updateColorMap();
 }
 
 float SpectrumRenderer::getMagnitudeMax() {
@@ -108,6 +159,13 @@ float SpectrumRenderer::getMagnitudeMax() {
 
 void SpectrumRenderer::setMagnitudeMax(float max) {
     _magnitudeMax = max;
+    _updateColorMap();
+}
+
+void SpectrumRenderer::setMagnitudeRange(float min, float max) {
+    _magnitudeMin = min;
+    _magnitudeMax = max;
+    _updateColorMap();
 }
 
 bool SpectrumRenderer::getMagnitudeLog() {
@@ -116,6 +174,7 @@ bool SpectrumRenderer::getMagnitudeLog() {
 
 void SpectrumRenderer::setMagnitudeLog(bool logarithmic) {
     _magnitudeLog = logarithmic;
+    _updateColorMap();
 }
 
 SpectrumRenderer::ColorScheme SpectrumRenderer::getColorScheme() {
@@ -124,6 +183,7 @@ SpectrumRenderer::ColorScheme SpectrumRenderer::getColorScheme() {
 
 void SpectrumRenderer::setColorScheme(ColorScheme colorScheme) {
     _colorScheme = colorScheme;
+    _updateColorMap();
 }
 
 std::string to_string(const SpectrumRenderer::ColorScheme &colorScheme) {
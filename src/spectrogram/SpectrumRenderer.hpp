@@ -3,6 +3,7 @@
 #include <vector>
 #include <complex>
 #include <cstdint>
+#include <cstddef>
 
 namespace Spectrogram {
 
@@ -12,11 +13,30 @@ class SpectrumRenderer {
                              Blue,
                              Grayscale };
 
+    /* Range of quantized magnitudes in dB */
+    static constexpr float QuantizedMagnitudeMin = -120.0f;
+    static constexpr float QuantizedMagnitudeMax = 120.0f;
+
     SpectrumRenderer(float magnitudeMin, float magnitudeMax, bool magnitudeLog, ColorScheme colorScheme);
 
     /* Render a new pixel row from a DFT vector */
     void render(std::vector<uint32_t> &pixels, const std::vector<std::complex<float>> &dft);
 
+    /* Render pixels from quantized magnitudes */
+    void render(uint32_t *pixels, const uint16_t *magnitudes, size_t count);
+
+    /* Quantize a DFT vector into a row of logarithmic magnitudes, resampled to the row width */
+    static void quantize(std::vector<uint16_t> &magnitudes, const std::vector<std::complex<float>> &dft);
+
+    /* Quantize a magnitude in dB, non-finite magnitudes to the floor */
+    static uint16_t quantize(float magnitude);
+
+    /* Dequantize a quantized magnitude to dB */
+    static float dequantize(uint16_t magnitude);
+
+    /* Resample a row of quantized magnitudes to the row width */
+    static void resample(std::vector<uint16_t> &magnitudes, const uint16_t *bins, size_t count);
+
     /* Get/Set Min Magnitude */
     float getMagnitudeMin();
     void setMagnitudeMin(float min);
@@ -25,6 +45,9 @@ class SpectrumRenderer {
     float getMagnitudeMax();
     void setMagnitudeMax(float max);
 
+    /* Set Min and Max Magnitude together */
+    void setMagnitudeRange(float min, float max);
+
     /* Get/Set Magnitude Linear/Log */
     bool getMagnitudeLog();
     void setMagnitudeLog(bool logarithmic);
@@ -34,10 +57,17 @@ class SpectrumRenderer {
     void setColorScheme(ColorScheme colorScheme);
 
   private:
+    void _updateColorMap();
+
     float _magnitudeMin;
     float _magnitudeMax;
     bool _magnitudeLog;
     ColorScheme _colorScheme;
+
+    /* Quantized magnitude to pixel lookup table */
+    std::vector<uint32_t> _colorMap;
+    /* Scratch quantized magnitudes for DFT rendering */
+    std::vector<uint16_t> _magnitudes;
 };
 
 std::string to_string(const SpectrumRenderer::ColorScheme &colorScheme);
@@ -0,0 +1,50 @@
+#include "TileCache.hpp"
+
+namespace Spectrogram {
+
+TileCache::TileCache(size_t capacity) : _capacity(capacity) {}
+
+const std::vector<uint16_t> *TileCache::get(uint64_t key) {
+    auto it = _index.find(key);
+    if (it == _index.end())
+        return nullptr;
+
+    /* Move to front of use order */
+    _tiles.splice(_tiles.begin(), _tiles, it->second);
+
+    return &it->second->second;
+}
+
+bool TileCache::contains(uint64_t key) {
+    return _index.find(key) != _index.end();
+}
+
+void TileCache::put(uint64_t key, std::vector<uint16_t> magnitudes) {
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        /* Replace existing tile */
+        it->second->second = std::move(magnitudes);
+        _tiles.splice(_tiles.begin(), _tiles, it->second);
+        return;
+    }
+
+    _tiles.emplace_front(key, std::move(magnitudes));
+    _index[key] = _tiles.begin();
+
+    /* Evict least recently used tiles */
+    while (_tiles.size() > _capacity) {
+        _index.erase(_tiles.back().first);
+        _tiles.pop_back();
+    }
+}
+
+void TileCache::clear() {
+    _tiles.clear();
+    _index.clear();
+}
+
+size_t TileCache::getCount() {
+    return _tiles.size();
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace Spectrogram {
+
+class TileCache {
+  public:
+    TileCache(size_t capacity);
+
+    /* Get tile of quantized magnitudes, marking it most recently used, or nullptr if not cached */
+    const std::vector<uint16_t> *get(uint64_t key);
+
+    /* Check if tile is cached, without marking it used */
+    bool contains(uint64_t key);
+
+    /* Put tile of quantized magnitudes, evicting least recently used tiles over capacity */
+    void put(uint64_t key, std::vector<uint16_t> magnitudes);
+
+    /* Evict all tiles */
+    void clear();
+
+    /* Get number of cached tiles */
+    size_t getCount();
+
+  private:
+    typedef std::pair<uint64_t, std::vector<uint16_t>> Tile;
+
+    /* Capacity in tiles */
+    size_t _capacity;
+    /* Tiles in most to least recently used order */
+    std::list<Tile> _tiles;
+    /* Tile lookup by key */
+    std::unordered_map<uint64_t, std::list<Tile>::iterator> _index;
+};
+
+}